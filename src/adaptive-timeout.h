@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ADAPTIVE_TIMEOUT_H
+#define ADAPTIVE_TIMEOUT_H
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libinput-util.h"
+
+/* A timeout that shortens to what the user actually needs. The caller
+ * records the gap each time the event the timeout waits for arrives in
+ * time. Once enough gaps are available, the timeout is the longest
+ * recent gap plus a margin, clamped to [min_timeout, max_timeout].
+ *
+ * If a shortened timeout expires and the awaited event follows within
+ * max_timeout, the timeout was too short: that gap is recorded too and
+ * the timeout grows back.
+ */
+struct adaptive_timeout {
+	bool enabled;
+	/* recent gaps, oldest overwritten first */
+	uint64_t gaps[16];
+	unsigned int ngaps;
+	unsigned int next;
+	/* learned timeout, max_timeout until min_samples are recorded */
+	uint64_t timeout;
+	/* start time of a shortened timeout that expired, 0 if none */
+	uint64_t expired_time;
+
+	uint64_t min_timeout;
+	uint64_t max_timeout;
+	uint64_t margin;
+	unsigned int min_samples;
+};
+
+static inline void
+adaptive_timeout_init(struct adaptive_timeout *at,
+		      uint64_t min_timeout,
+		      uint64_t max_timeout,
+		      uint64_t margin,
+		      unsigned int min_samples)
+{
+	assert(min_samples <= ARRAY_LENGTH(at->gaps));
+
+	*at = (struct adaptive_timeout) {
+		.enabled = false,
+		.timeout = max_timeout,
+		.min_timeout = min_timeout,
+		.max_timeout = max_timeout,
+		.margin = margin,
+		.min_samples = min_samples,
+	};
+}
+
+/**
+ * @return the timeout to use, the learned one if enabled or the maximum
+ * otherwise
+ */
+static inline uint64_t
+adaptive_timeout_get(const struct adaptive_timeout *at)
+{
+	return at->enabled ? at->timeout : at->max_timeout;
+}
+
+/**
+ * Record the gap between the start of the timeout and the awaited event.
+ *
+ * @return true if the learned timeout changed
+ */
+static inline bool
+adaptive_timeout_add_gap(struct adaptive_timeout *at, uint64_t gap)
+{
+	unsigned int sz = ARRAY_LENGTH(at->gaps);
+	uint64_t longest = 0;
+	uint64_t timeout;
+	unsigned int i;
+
+	at->gaps[at->next] = gap;
+	at->next = (at->next + 1) % sz;
+	at->ngaps = min(at->ngaps + 1, sz);
+
+	if (at->ngaps < at->min_samples)
+		return false;
+
+	for (i = 0; i < at->ngaps; i++)
+		longest = max(longest, at->gaps[i]);
+
+	timeout = min(max(longest + at->margin, at->min_timeout),
+		      at->max_timeout);
+	if (timeout == at->timeout)
+		return false;
+
+	at->timeout = timeout;
+	return true;
+}
+
+/**
+ * The timeout started at start_time expired. If it was shortened, remember
+ * the start time so adaptive_timeout_check_expired() can detect a miss.
+ */
+static inline void
+adaptive_timeout_expired(struct adaptive_timeout *at, uint64_t start_time)
+{
+	if (at->enabled && at->timeout < at->max_timeout)
+		at->expired_time = start_time;
+}
+
+/**
+ * Call when the awaited event arrives after the timeout expired. If it
+ * arrived within max_timeout of a shortened timeout's start, the timeout
+ * was too short and the gap is recorded.
+ *
+ * @return true if the learned timeout changed
+ */
+static inline bool
+adaptive_timeout_check_expired(struct adaptive_timeout *at, uint64_t now)
+{
+	uint64_t start = at->expired_time;
+
+	at->expired_time = 0;
+
+	if (start != 0 && now - start < at->max_timeout)
+		return adaptive_timeout_add_gap(at, now - start);
+
+	return false;
+}
+
+static inline void
+adaptive_timeout_clear_expired(struct adaptive_timeout *at)
+{
+	at->expired_time = 0;
+}
+
+#endif
@@ -58,6 +58,10 @@
    7 and 8 are cases where the first event happens within the first timeout
    but the second event is outside that timeout (but within the timeout of
    the second event). These cases are currently unhandled.
+
+   Each button has its own state machine and timeouts, so a button
+   changing state does not affect the debouncing of any other button. All
+   buttons share one timer that is set to the earliest pending timeout.
 */
 
 enum debounce_event {
@@ -65,7 +69,6 @@ enum debounce_event {
 	DEBOUNCE_EVENT_RELEASE,
 	DEBOUNCE_EVENT_TIMEOUT,
 	DEBOUNCE_EVENT_TIMEOUT_SHORT,
-	DEBOUNCE_EVENT_OTHERBUTTON,
 };
 
 static inline const char *
@@ -95,61 +98,82 @@ debounce_event_to_str(enum debounce_event event)
 	CASE_RETURN_STRING(DEBOUNCE_EVENT_RELEASE);
 	CASE_RETURN_STRING(DEBOUNCE_EVENT_TIMEOUT);
 	CASE_RETURN_STRING(DEBOUNCE_EVENT_TIMEOUT_SHORT);
-	CASE_RETURN_STRING(DEBOUNCE_EVENT_OTHERBUTTON);
 	}
 	return NULL;
 }
 
 static inline void
-log_debounce_bug(struct fallback_dispatch *fallback, enum debounce_event event)
+log_debounce_bug(struct fallback_dispatch *fallback,
+		 struct debounce_button *button,
+		 enum debounce_event event)
 {
 	evdev_log_bug_libinput(fallback->device,
-			       "invalid debounce event %s in state %s\n",
+			       "invalid debounce event %s in state %s for button %d\n",
 			       debounce_event_to_str(event),
-			       debounce_state_to_str(fallback->debounce.state));
+			       debounce_state_to_str(button->state),
+			       button->code);
 
 }
 
 static inline void
-debounce_set_state(struct fallback_dispatch *fallback,
+debounce_set_state(struct debounce_button *button,
 		   enum debounce_state new_state)
 {
 	assert(new_state >= DEBOUNCE_STATE_IS_UP &&
 	       new_state <= DEBOUNCE_STATE_PRESS_PENDING);
 
-	fallback->debounce.state = new_state;
+	button->state = new_state;
 }
 
 static inline void
-debounce_set_timer(struct fallback_dispatch *fallback,
+debounce_set_timer(struct debounce_button *button,
 		   uint64_t time)
 {
 	const int DEBOUNCE_TIMEOUT_BOUNCE = ms2us(25);
 
-	libinput_timer_set(&fallback->debounce.timer,
-			   time + DEBOUNCE_TIMEOUT_BOUNCE);
+	button->timeout = time + DEBOUNCE_TIMEOUT_BOUNCE;
 }
 
 static inline void
-debounce_set_timer_short(struct fallback_dispatch *fallback,
+debounce_set_timer_short(struct debounce_button *button,
 			 uint64_t time)
 {
 	const int DEBOUNCE_TIMEOUT_SPURIOUS = ms2us(12);
 
-	libinput_timer_set(&fallback->debounce.timer_short,
-			   time + DEBOUNCE_TIMEOUT_SPURIOUS);
+	button->timeout_short = time + DEBOUNCE_TIMEOUT_SPURIOUS;
 }
 
 static inline void
-debounce_cancel_timer(struct fallback_dispatch *fallback)
+debounce_cancel_timer(struct debounce_button *button)
 {
-	libinput_timer_cancel(&fallback->debounce.timer);
+	button->timeout = 0;
 }
 
 static inline void
-debounce_cancel_timer_short(struct fallback_dispatch *fallback)
+debounce_cancel_timer_short(struct debounce_button *button)
+{
+	button->timeout_short = 0;
+}
+
+/* Set the shared timer to the earliest timeout of any button */
+static void
+debounce_update_timer(struct fallback_dispatch *fallback)
 {
-	libinput_timer_cancel(&fallback->debounce.timer_short);
+	uint64_t expire = UINT64_MAX;
+
+	for (size_t i = 0; i < fallback->debounce.nbuttons; i++) {
+		struct debounce_button *button = &fallback->debounce.buttons[i];
+
+		if (button->timeout_short)
+			expire = min(expire, button->timeout_short);
+		if (button->timeout)
+			expire = min(expire, button->timeout);
+	}
+
+	if (expire == UINT64_MAX)
+		libinput_timer_cancel(&fallback->debounce.timer);
+	else
+		libinput_timer_set(&fallback->debounce.timer, expire);
 }
 
 static inline void
@@ -168,11 +192,12 @@ debounce_enable_spurious(struct fallback_dispatch *fallback)
 
 static void
 debounce_notify_button(struct fallback_dispatch *fallback,
+		       struct debounce_button *button,
 		       enum libinput_button_state state)
 {
 	struct evdev_device *device = fallback->device;
-	unsigned int code = fallback->debounce.button_code;
-	uint64_t time = fallback->debounce.button_time;
+	unsigned int code = button->code;
+	uint64_t time = button->time;
 
 	code = evdev_to_left_handed(device, code);
 
@@ -180,214 +205,229 @@ debounce_notify_button(struct fallback_dispatch *fallback,
 }
 
 static void
-debounce_is_up_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_is_up_handle_event(struct fallback_dispatch *fallback,
+			    struct debounce_button *button,
+			    enum debounce_event event,
+			    uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		fallback->debounce.button_time = time;
-		debounce_set_timer(fallback, time);
-		debounce_set_state(fallback, DEBOUNCE_STATE_DOWN_WAITING);
+		button->time = time;
+		debounce_set_timer(button, time);
+		debounce_set_state(button, DEBOUNCE_STATE_DOWN_WAITING);
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_PRESSED);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
 	case DEBOUNCE_EVENT_TIMEOUT:
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(fallback, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
+		log_debounce_bug(fallback, button, event);
 		break;
 	}
 }
 
 static void
-debounce_is_down_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_is_down_handle_event(struct fallback_dispatch *fallback,
+			      struct debounce_button *button,
+			      enum debounce_event event,
+			      uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
-		fallback->debounce.button_time = time;
-		debounce_set_timer(fallback, time);
-		debounce_set_timer_short(fallback, time);
+		button->time = time;
+		debounce_set_timer(button, time);
+		debounce_set_timer_short(button, time);
 		if (fallback->debounce.spurious_enabled) {
-			debounce_set_state(fallback, DEBOUNCE_STATE_RELEASE_DELAYED);
+			debounce_set_state(button, DEBOUNCE_STATE_RELEASE_DELAYED);
 		} else {
-			debounce_set_state(fallback, DEBOUNCE_STATE_RELEASE_WAITING);
+			debounce_set_state(button, DEBOUNCE_STATE_RELEASE_WAITING);
 			debounce_notify_button(fallback,
+					       button,
 					       LIBINPUT_BUTTON_STATE_RELEASED);
 		}
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT:
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(fallback, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
+		log_debounce_bug(fallback, button, event);
 		break;
 	}
 }
 
 static void
-debounce_down_waiting_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_down_waiting_handle_event(struct fallback_dispatch *fallback,
+				   struct debounce_button *button,
+				   enum debounce_event event,
+				   uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
-		debounce_set_state(fallback, DEBOUNCE_STATE_RELEASE_PENDING);
+		debounce_set_state(button, DEBOUNCE_STATE_RELEASE_PENDING);
 		/* Note: In the debouncing RPR case, we use the last
 		 * release's time stamp */
-		fallback->debounce.button_time = time;
+		button->time = time;
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_DOWN);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_DOWN);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(fallback, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_DOWN);
+		log_debounce_bug(fallback, button, event);
 		break;
 	}
 }
 
 static void
-debounce_release_pending_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_release_pending_handle_event(struct fallback_dispatch *fallback,
+				      struct debounce_button *button,
+				      enum debounce_event event,
+				      uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		debounce_set_state(fallback, DEBOUNCE_STATE_DOWN_WAITING);
+		debounce_set_state(button, DEBOUNCE_STATE_DOWN_WAITING);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_UP);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_UP);
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_RELEASED);
 		break;
 	}
 }
 
 static void
-debounce_release_delayed_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_release_delayed_handle_event(struct fallback_dispatch *fallback,
+				      struct debounce_button *button,
+				      enum debounce_event event,
+				      uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_DOWN);
-		debounce_cancel_timer(fallback);
-		debounce_cancel_timer_short(fallback);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_DOWN);
+		debounce_cancel_timer(button);
+		debounce_cancel_timer_short(button);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
 	case DEBOUNCE_EVENT_TIMEOUT:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		debounce_set_state(fallback, DEBOUNCE_STATE_RELEASE_WAITING);
-		debounce_notify_button(fallback,
-				       LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_UP);
+		debounce_set_state(button, DEBOUNCE_STATE_RELEASE_WAITING);
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_RELEASED);
 		break;
 	}
 }
 
 static void
-debounce_release_waiting_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_release_waiting_handle_event(struct fallback_dispatch *fallback,
+				      struct debounce_button *button,
+				      enum debounce_event event,
+				      uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
 		/* Note: in a bouncing PRP case, we use the last press
 		 * event time */
-		fallback->debounce.button_time = time;
-		debounce_set_state(fallback, DEBOUNCE_STATE_MAYBE_SPURIOUS);
+		button->time = time;
+		debounce_set_state(button, DEBOUNCE_STATE_MAYBE_SPURIOUS);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_UP);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_UP);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		debounce_set_state(fallback, DEBOUNCE_STATE_RELEASED);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_UP);
+		debounce_set_state(button, DEBOUNCE_STATE_RELEASED);
 		break;
 	}
 }
 
 static void
-debounce_maybe_spurious_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_maybe_spurious_handle_event(struct fallback_dispatch *fallback,
+				     struct debounce_button *button,
+				     enum debounce_event event,
+				     uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
-		debounce_set_state(fallback, DEBOUNCE_STATE_RELEASE_WAITING);
+		debounce_set_state(button, DEBOUNCE_STATE_RELEASE_WAITING);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		debounce_cancel_timer(fallback);
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_DOWN);
+		debounce_cancel_timer(button);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_DOWN);
 		debounce_enable_spurious(fallback);
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_PRESSED);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_DOWN);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_DOWN);
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_PRESSED);
 		break;
 	}
 }
 
 static void
-debounce_released_handle_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_released_handle_event(struct fallback_dispatch *fallback,
+			       struct debounce_button *button,
+			       enum debounce_event event,
+			       uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
 		/* Note: in a debouncing PRP case, we use the last press'
 		 * time */
-		fallback->debounce.button_time = time;
-		debounce_set_state(fallback, DEBOUNCE_STATE_PRESS_PENDING);
+		button->time = time;
+		debounce_set_state(button, DEBOUNCE_STATE_PRESS_PENDING);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_UP);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_UP);
 		break;
 	}
 }
 
 static void
-debounce_press_pending_event(struct fallback_dispatch *fallback, enum debounce_event event, uint64_t time)
+debounce_press_pending_event(struct fallback_dispatch *fallback,
+			     struct debounce_button *button,
+			     enum debounce_event event,
+			     uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
-		debounce_set_state(fallback, DEBOUNCE_STATE_RELEASED);
+		debounce_set_state(button, DEBOUNCE_STATE_RELEASED);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(fallback, event);
+		log_debounce_bug(fallback, button, event);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(fallback, DEBOUNCE_STATE_IS_DOWN);
+		debounce_set_state(button, DEBOUNCE_STATE_IS_DOWN);
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_PRESSED);
 		break;
 	}
@@ -395,192 +435,231 @@ debounce_press_pending_event(struct fallback_dispatch *fallback, enum debounce_e
 
 static void
 debounce_disabled_event(struct fallback_dispatch *fallback,
+			struct debounce_button *button,
 			enum debounce_event event,
 			uint64_t time)
 {
 	switch (event) {
 	case DEBOUNCE_EVENT_PRESS:
-		fallback->debounce.button_time = time;
+		button->time = time;
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_PRESSED);
 		break;
 	case DEBOUNCE_EVENT_RELEASE:
-		fallback->debounce.button_time = time;
+		button->time = time;
 		debounce_notify_button(fallback,
+				       button,
 				       LIBINPUT_BUTTON_STATE_RELEASED);
 		break;
 	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
 	case DEBOUNCE_EVENT_TIMEOUT:
-		log_debounce_bug(fallback, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
+		log_debounce_bug(fallback, button, event);
 		break;
 	}
 }
 
 static void
 debounce_handle_event(struct fallback_dispatch *fallback,
+		      struct debounce_button *button,
 		      enum debounce_event event,
 		      uint64_t time)
 {
-	enum debounce_state current = fallback->debounce.state;
-
-	if (event == DEBOUNCE_EVENT_OTHERBUTTON) {
-		debounce_cancel_timer(fallback);
-		debounce_cancel_timer_short(fallback);
-	}
+	enum debounce_state current = button->state;
 
 	switch(current) {
 	case DEBOUNCE_STATE_IS_UP:
-		debounce_is_up_handle_event(fallback, event, time);
+		debounce_is_up_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_IS_DOWN:
-		debounce_is_down_handle_event(fallback, event, time);
+		debounce_is_down_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_DOWN_WAITING:
-		debounce_down_waiting_handle_event(fallback, event, time);
+		debounce_down_waiting_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_RELEASE_PENDING:
-		debounce_release_pending_handle_event(fallback, event, time);
+		debounce_release_pending_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_RELEASE_DELAYED:
-		debounce_release_delayed_handle_event(fallback, event, time);
+		debounce_release_delayed_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_RELEASE_WAITING:
-		debounce_release_waiting_handle_event(fallback, event, time);
+		debounce_release_waiting_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_MAYBE_SPURIOUS:
-		debounce_maybe_spurious_handle_event(fallback, event, time);
+		debounce_maybe_spurious_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_RELEASED:
-		debounce_released_handle_event(fallback, event, time);
+		debounce_released_handle_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_PRESS_PENDING:
-		debounce_press_pending_event(fallback, event, time);
+		debounce_press_pending_event(fallback, button, event, time);
 		break;
 	case DEBOUNCE_STATE_DISABLED:
-		debounce_disabled_event(fallback, event, time);
+		debounce_disabled_event(fallback, button, event, time);
 		break;
 	}
 
 	evdev_log_debug(fallback->device,
-			"debounce state: %s → %s → %s\n",
+			"debounce state %d: %s → %s → %s\n",
+			button->code,
 			debounce_state_to_str(current),
 			debounce_event_to_str(event),
-			debounce_state_to_str(fallback->debounce.state));
+			debounce_state_to_str(button->state));
 }
 
-void
-fallback_debounce_handle_state(struct fallback_dispatch *dispatch,
-			       uint64_t time)
+/* Find the button with the earliest timeout that expired at or before
+ * now and clear that timeout. On a tie, the short timeout goes first. */
+static struct debounce_button *
+debounce_next_expired(struct fallback_dispatch *dispatch,
+		      uint64_t now,
+		      enum debounce_event *event)
 {
-	unsigned int changed[16] = {0}; /* event codes of changed buttons */
-	size_t nchanged = 0;
-	bool flushed = false;
+	struct debounce_button *expired = NULL;
+	uint64_t expire = now + 1;
 
-	for (unsigned int code = 0; code <= KEY_MAX; code++) {
-		if (get_key_type(code) != KEY_TYPE_BUTTON)
-			continue;
+	for (size_t i = 0; i < dispatch->debounce.nbuttons; i++) {
+		struct debounce_button *button = &dispatch->debounce.buttons[i];
 
-		if (hw_key_has_changed(dispatch, code))
-			changed[nchanged++] = code;
+		if (button->timeout_short && button->timeout_short < expire) {
+			expired = button;
+			expire = button->timeout_short;
+			*event = DEBOUNCE_EVENT_TIMEOUT_SHORT;
+		}
+		if (button->timeout && button->timeout < expire) {
+			expired = button;
+			expire = button->timeout;
+			*event = DEBOUNCE_EVENT_TIMEOUT;
+		}
+	}
 
-		/* If you manage to press more than 16 buttons in the same
-		 * frame, we just quietly ignore the rest of them */
-		if (nchanged == ARRAY_LENGTH(changed))
-			break;
+	if (expired) {
+		if (*event == DEBOUNCE_EVENT_TIMEOUT_SHORT)
+			debounce_cancel_timer_short(expired);
+		else
+			debounce_cancel_timer(expired);
 	}
 
-	/* If we have more than one button this frame or a different button,
-	 * flush the state machine with otherbutton */
-	if (nchanged > 1 ||
-	    changed[0] != dispatch->debounce.button_code) {
-		debounce_handle_event(dispatch,
-				      DEBOUNCE_EVENT_OTHERBUTTON,
-				      time);
-		flushed = true;
+	return expired;
+}
+
+static void
+debounce_flush_timeouts(struct fallback_dispatch *dispatch, uint64_t now)
+{
+	struct debounce_button *button;
+	enum debounce_event event;
+
+	while ((button = debounce_next_expired(dispatch, now, &event)))
+		debounce_handle_event(dispatch, button, event, now);
+}
+
+/* The buttons are sorted by code, see fallback_init_debounce() */
+static struct debounce_button *
+debounce_find_button(struct fallback_dispatch *dispatch, unsigned int code)
+{
+	size_t lo = 0,
+	       hi = dispatch->debounce.nbuttons;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo)/2;
+		struct debounce_button *button = &dispatch->debounce.buttons[mid];
+
+		if (button->code == code)
+			return button;
+
+		if (button->code < code)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
 
-	/* The state machine has some pre-conditions:
-	 * - the IS_DOWN and IS_UP states are neutral entry states without
-	 *   any timeouts
-	 * - a OTHERBUTTON event always flushes the state to IS_DOWN or
-	 *   IS_UP
-	 */
+	return NULL;
+}
 
+void
+fallback_debounce_handle_state(struct fallback_dispatch *dispatch,
+			       uint64_t time)
+{
+	/* Large enough for every KEY_TYPE_BUTTON code (126), so no change
+	 * is ever cut off */
+	unsigned int codes[128];
+	size_t nchanged;
+
+	/* Another button's timeout may have expired before this event but
+	 * the timer hasn't been dispatched yet, handle it first */
+	debounce_flush_timeouts(dispatch, time);
+
+	nchanged = hw_key_get_changed(dispatch,
+				      dispatch->button_mask,
+				      codes,
+				      ARRAY_LENGTH(codes));
 	for (size_t i = 0; i < nchanged; i++) {
-		bool is_down = hw_is_key_down(dispatch, changed[i]);
-
-		if (flushed &&
-		    dispatch->debounce.state != DEBOUNCE_STATE_DISABLED) {
-			debounce_set_state(dispatch,
-					   !is_down ?
-						   DEBOUNCE_STATE_IS_DOWN :
-						   DEBOUNCE_STATE_IS_UP);
-			flushed = false;
-		}
+		struct debounce_button *button;
+		bool is_down;
+
+		button = debounce_find_button(dispatch, codes[i]);
+		if (!button)
+			continue;
 
-		dispatch->debounce.button_code = changed[i];
+		is_down = hw_is_key_down(dispatch, button->code);
 		debounce_handle_event(dispatch,
+				      button,
 				      is_down ?
 					      DEBOUNCE_EVENT_PRESS :
 					      DEBOUNCE_EVENT_RELEASE,
 				      time);
-
-		/* if we have more than one event, we flush the state
-		 * machine immediately after the event itself */
-		if (nchanged > 1) {
-			debounce_handle_event(dispatch,
-					      DEBOUNCE_EVENT_OTHERBUTTON,
-					      time);
-			flushed = true;
-		}
-
 	}
-}
 
-static void
-debounce_timeout(uint64_t now, void *data)
-{
-	struct evdev_device *device = data;
-	struct fallback_dispatch *dispatch =
-		fallback_dispatch(device->dispatch);
-
-	debounce_handle_event(dispatch, DEBOUNCE_EVENT_TIMEOUT, now);
+	debounce_update_timer(dispatch);
 }
 
 static void
-debounce_timeout_short(uint64_t now, void *data)
+debounce_timeout(uint64_t now, void *data)
 {
 	struct evdev_device *device = data;
 	struct fallback_dispatch *dispatch =
 		fallback_dispatch(device->dispatch);
 
-	debounce_handle_event(dispatch, DEBOUNCE_EVENT_TIMEOUT_SHORT, now);
+	debounce_flush_timeouts(dispatch, now);
+	debounce_update_timer(dispatch);
 }
 
 void
 fallback_init_debounce(struct fallback_dispatch *dispatch)
 {
 	struct evdev_device *device = dispatch->device;
+	enum debounce_state state = DEBOUNCE_STATE_IS_UP;
 	char timer_name[64];
+	size_t nbuttons = 0;
 
-	if (device->model_flags & EVDEV_MODEL_BOUNCING_KEYS) {
-		dispatch->debounce.state = DEBOUNCE_STATE_DISABLED;
-		return;
+	if (device->model_flags & EVDEV_MODEL_BOUNCING_KEYS)
+		state = DEBOUNCE_STATE_DISABLED;
+
+	for (unsigned int code = 0; code <= KEY_MAX; code++) {
+		if (long_bit_is_set(dispatch->button_mask, code) &&
+		    libevdev_has_event_code(device->evdev, EV_KEY, code))
+			nbuttons++;
 	}
 
-	dispatch->debounce.state = DEBOUNCE_STATE_IS_UP;
+	if (nbuttons == 0)
+		return;
 
-	snprintf(timer_name,
-		 sizeof(timer_name),
-		 "%s debounce short",
-		 evdev_device_get_sysname(device));
-	libinput_timer_init(&dispatch->debounce.timer_short,
-			    evdev_libinput_context(device),
-			    timer_name,
-			    debounce_timeout_short,
-			    device);
+	dispatch->debounce.buttons = zalloc(nbuttons *
+					    sizeof(*dispatch->debounce.buttons));
+	for (unsigned int code = 0; code <= KEY_MAX; code++) {
+		struct debounce_button *button;
+
+		if (!long_bit_is_set(dispatch->button_mask, code) ||
+		    !libevdev_has_event_code(device->evdev, EV_KEY, code))
+			continue;
+
+		button = &dispatch->debounce.buttons[dispatch->debounce.nbuttons++];
+		button->code = code;
+		button->state = state;
+	}
+
+	if (state == DEBOUNCE_STATE_DISABLED)
+		return;
 
 	snprintf(timer_name,
 		 sizeof(timer_name),
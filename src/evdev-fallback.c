@@ -26,7 +26,9 @@
 
 #include "config.h"
 
+#if HAVE_MTDEV
 #include <mtdev-plumbing.h>
+#endif
 
 #include "evdev-fallback.h"
 
@@ -177,6 +179,8 @@ fallback_flush_relative_motion(struct fallback_dispatch *dispatch,
 	dispatch->rel.x = 0;
 	dispatch->rel.y = 0;
 
+	evdev_update_report_rate(device, time);
+
 	/* Use unaccelerated deltas for pointing stick scroll */
 	if (post_trackpoint_scroll(device, unaccel, time))
 		return;
@@ -304,13 +308,8 @@ fallback_flush_mt_down(struct fallback_dispatch *dispatch,
 		return false;
 	}
 
-	seat_slot = ffs(~seat->slot_map) - 1;
+	seat_slot = libinput_seat_acquire_slot(seat);
 	slot->seat_slot = seat_slot;
-
-	if (seat_slot == -1)
-		return false;
-
-	seat->slot_map |= 1 << seat_slot;
 	point = slot->point;
 	slot->hysteresis_center = point;
 	evdev_transform_absolute(device, &point);
@@ -373,7 +372,7 @@ fallback_flush_mt_up(struct fallback_dispatch *dispatch,
 	if (seat_slot == -1)
 		return false;
 
-	seat->slot_map &= ~(1 << seat_slot);
+	libinput_seat_release_slot(seat, seat_slot);
 
 	touch_notify_touch_up(base, time, slot_idx, seat_slot);
 
@@ -399,14 +398,9 @@ fallback_flush_st_down(struct fallback_dispatch *dispatch,
 		return false;
 	}
 
-	seat_slot = ffs(~seat->slot_map) - 1;
+	seat_slot = libinput_seat_acquire_slot(seat);
 	dispatch->abs.seat_slot = seat_slot;
 
-	if (seat_slot == -1)
-		return false;
-
-	seat->slot_map |= 1 << seat_slot;
-
 	point = dispatch->abs.point;
 	evdev_transform_absolute(device, &point);
 
@@ -455,7 +449,7 @@ fallback_flush_st_up(struct fallback_dispatch *dispatch,
 	if (seat_slot == -1)
 		return false;
 
-	seat->slot_map &= ~(1 << seat_slot);
+	libinput_seat_release_slot(seat, seat_slot);
 
 	touch_notify_touch_up(base, time, -1, seat_slot);
 
@@ -529,6 +523,192 @@ fallback_process_key(struct fallback_dispatch *dispatch,
 	}
 }
 
+static void
+fallback_process_touch_protocol_a(struct fallback_dispatch *dispatch,
+				  struct evdev_device *device,
+				  struct input_event *e)
+{
+	struct mt_contact *contact = &dispatch->mt.protocol_a.current;
+
+	switch (e->code) {
+	case ABS_MT_TRACKING_ID:
+		contact->tracking_id = e->value;
+		break;
+	case ABS_MT_POSITION_X:
+		evdev_device_check_abs_axis_range(device, e->code, e->value);
+		contact->point.x = e->value;
+		break;
+	case ABS_MT_POSITION_Y:
+		evdev_device_check_abs_axis_range(device, e->code, e->value);
+		contact->point.y = e->value;
+		break;
+	default:
+		return;
+	}
+
+	dispatch->mt.protocol_a.have_current = true;
+}
+
+static void
+fallback_protocol_a_end_contact(struct fallback_dispatch *dispatch)
+{
+	struct mt_contact *current = &dispatch->mt.protocol_a.current;
+
+	/* More contacts than slots: drop the excess, like mtdev did */
+	if (dispatch->mt.protocol_a.have_current &&
+	    dispatch->mt.protocol_a.ncontacts < PROTOCOL_A_NUM_SLOTS) {
+		size_t idx = dispatch->mt.protocol_a.ncontacts++;
+
+		dispatch->mt.protocol_a.contacts[idx] = *current;
+	}
+
+	current->tracking_id = -1;
+	dispatch->mt.protocol_a.have_current = false;
+}
+
+static inline bool
+fallback_protocol_a_slot_is_active(struct fallback_dispatch *dispatch,
+				   size_t slot_idx)
+{
+	enum mt_slot_state state = dispatch->mt.slots[slot_idx].state;
+
+	return state == SLOT_STATE_BEGIN || state == SLOT_STATE_UPDATE;
+}
+
+static inline void
+fallback_protocol_a_update_slot(struct fallback_dispatch *dispatch,
+				size_t slot_idx,
+				const struct mt_contact *contact)
+{
+	struct mt_slot *slot = &dispatch->mt.slots[slot_idx];
+
+	if (slot->point.x == contact->point.x &&
+	    slot->point.y == contact->point.y)
+		return;
+
+	slot->point = contact->point;
+	long_set_bit(dispatch->mt.dirty_slots, slot_idx);
+	dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
+}
+
+/**
+ * Protocol A devices send an unordered list of contacts per frame.
+ * Assign each contact to a slot: contacts with a tracking ID go to the
+ * slot with the same ID, untracked contacts to the nearest active slot
+ * that was begun by an untracked contact. A tracked slot never continues
+ * with an untracked contact and vice versa.
+ * Slots without a contact end, contacts without a slot begin a new one.
+ */
+static void
+fallback_protocol_a_assign_slots(struct fallback_dispatch *dispatch)
+{
+	struct mt_contact *contacts = dispatch->mt.protocol_a.contacts;
+	int32_t *tracking_ids = dispatch->mt.protocol_a.tracking_ids;
+	size_t ncontacts;
+	size_t nslots = dispatch->mt.slots_len;
+	bool slot_used[PROTOCOL_A_NUM_SLOTS] = { false };
+	bool contact_used[PROTOCOL_A_NUM_SLOTS] = { false };
+
+	/* a contact not terminated by SYN_MT_REPORT still counts */
+	fallback_protocol_a_end_contact(dispatch);
+	ncontacts = dispatch->mt.protocol_a.ncontacts;
+	dispatch->mt.protocol_a.ncontacts = 0;
+
+	for (size_t c = 0; c < ncontacts; c++) {
+		if (contacts[c].tracking_id < 0)
+			continue;
+
+		for (size_t s = 0; s < nslots; s++) {
+			if (slot_used[s] ||
+			    !fallback_protocol_a_slot_is_active(dispatch, s) ||
+			    tracking_ids[s] != contacts[c].tracking_id)
+				continue;
+
+			fallback_protocol_a_update_slot(dispatch,
+							s,
+							&contacts[c]);
+			slot_used[s] = true;
+			contact_used[c] = true;
+			break;
+		}
+	}
+
+	/* Untracked contacts: repeatedly pair the closest remaining
+	 * contact and untracked active slot. With at most slots_len of
+	 * each, the cubic cost is negligible. */
+	while (true) {
+		uint64_t best_dist = UINT64_MAX;
+		size_t best_c = 0, best_s = 0;
+
+		for (size_t c = 0; c < ncontacts; c++) {
+			if (contact_used[c] ||
+			    contacts[c].tracking_id >= 0)
+				continue;
+
+			for (size_t s = 0; s < nslots; s++) {
+				struct mt_slot *slot = &dispatch->mt.slots[s];
+				int64_t dx, dy;
+				uint64_t dist;
+
+				if (slot_used[s] ||
+				    tracking_ids[s] >= 0 ||
+				    !fallback_protocol_a_slot_is_active(dispatch, s))
+					continue;
+
+				dx = (int64_t)contacts[c].point.x - slot->point.x;
+				dy = (int64_t)contacts[c].point.y - slot->point.y;
+				dist = dx * dx + dy * dy;
+				if (dist < best_dist) {
+					best_dist = dist;
+					best_c = c;
+					best_s = s;
+				}
+			}
+		}
+
+		if (best_dist == UINT64_MAX)
+			break;
+
+		fallback_protocol_a_update_slot(dispatch,
+						best_s,
+						&contacts[best_c]);
+		slot_used[best_s] = true;
+		contact_used[best_c] = true;
+	}
+
+	for (size_t s = 0; s < nslots; s++) {
+		if (slot_used[s] ||
+		    !fallback_protocol_a_slot_is_active(dispatch, s))
+			continue;
+
+		dispatch->mt.slots[s].state = SLOT_STATE_END;
+		tracking_ids[s] = -1;
+		long_set_bit(dispatch->mt.dirty_slots, s);
+		dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
+	}
+
+	for (size_t c = 0; c < ncontacts; c++) {
+		size_t s;
+
+		if (contact_used[c])
+			continue;
+
+		for (s = 0; s < nslots; s++) {
+			if (dispatch->mt.slots[s].state == SLOT_STATE_NONE)
+				break;
+		}
+
+		if (s == nslots)
+			break;
+
+		dispatch->mt.slots[s].state = SLOT_STATE_BEGIN;
+		dispatch->mt.slots[s].point = contacts[c].point;
+		tracking_ids[s] = contacts[c].tracking_id;
+		long_set_bit(dispatch->mt.dirty_slots, s);
+		dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
+	}
+}
+
 static void
 fallback_process_touch(struct fallback_dispatch *dispatch,
 		       struct evdev_device *device,
@@ -536,6 +716,12 @@ fallback_process_touch(struct fallback_dispatch *dispatch,
 		       uint64_t time)
 {
 	struct mt_slot *slot = &dispatch->mt.slots[dispatch->mt.slot];
+	unsigned long *dirty_slots = dispatch->mt.dirty_slots;
+
+	if (dispatch->mt.protocol_a.enabled) {
+		fallback_process_touch_protocol_a(dispatch, device, e);
+		return;
+	}
 
 	if (e->code == ABS_MT_SLOT) {
 		if ((size_t)e->value >= dispatch->mt.slots_len) {
@@ -558,19 +744,19 @@ fallback_process_touch(struct fallback_dispatch *dispatch,
 			dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
 			slot->state = SLOT_STATE_END;
 		}
-		slot->dirty = true;
+		long_set_bit(dirty_slots, dispatch->mt.slot);
 		break;
 	case ABS_MT_POSITION_X:
 		evdev_device_check_abs_axis_range(device, e->code, e->value);
 		dispatch->mt.slots[dispatch->mt.slot].point.x = e->value;
 		dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
-		slot->dirty = true;
+		long_set_bit(dirty_slots, dispatch->mt.slot);
 		break;
 	case ABS_MT_POSITION_Y:
 		evdev_device_check_abs_axis_range(device, e->code, e->value);
 		dispatch->mt.slots[dispatch->mt.slot].point.y = e->value;
 		dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
-		slot->dirty = true;
+		long_set_bit(dirty_slots, dispatch->mt.slot);
 		break;
 	}
 }
@@ -818,33 +1004,39 @@ fallback_handle_state(struct fallback_dispatch *dispatch,
 
 	/* Multitouch devices */
 	if (dispatch->pending_event & EVDEV_ABSOLUTE_MT) {
+		unsigned long *dirty_slots = dispatch->mt.dirty_slots;
 		bool sent = false;
-		for (size_t i = 0; i < dispatch->mt.slots_len; i++) {
-			struct mt_slot *slot = &dispatch->mt.slots[i];
-
-			if (!slot->dirty)
-				continue;
 
-			if (slot->state == SLOT_STATE_BEGIN) {
-				sent = fallback_flush_mt_down(dispatch,
-							      device,
-							      i,
-							      time);
-				slot->state = SLOT_STATE_UPDATE;
-			} else if (slot->state == SLOT_STATE_UPDATE) {
-				sent = fallback_flush_mt_motion(dispatch,
-								device,
-								i,
-								time);
-			} else if (slot->state == SLOT_STATE_END) {
-				sent = fallback_flush_mt_up(dispatch,
-							    device,
-							    i,
-							    time);
-				slot->state = SLOT_STATE_NONE;
+		for (size_t w = 0; w < NLONGS(dispatch->mt.slots_len); w++) {
+			unsigned long dirty = dirty_slots[w];
+
+			dirty_slots[w] = 0;
+
+			while (dirty != 0) {
+				size_t i = w * LONG_BITS + __builtin_ctzl(dirty);
+				struct mt_slot *slot = &dispatch->mt.slots[i];
+
+				dirty &= dirty - 1;
+
+				if (slot->state == SLOT_STATE_BEGIN) {
+					sent = fallback_flush_mt_down(dispatch,
+								      device,
+								      i,
+								      time);
+					slot->state = SLOT_STATE_UPDATE;
+				} else if (slot->state == SLOT_STATE_UPDATE) {
+					sent = fallback_flush_mt_motion(dispatch,
+									device,
+									i,
+									time);
+				} else if (slot->state == SLOT_STATE_END) {
+					sent = fallback_flush_mt_up(dispatch,
+								    device,
+								    i,
+								    time);
+					slot->state = SLOT_STATE_NONE;
+				}
 			}
-
-			slot->dirty = false;
 		}
 
 		need_touch_frame = sent;
@@ -857,18 +1049,12 @@ fallback_handle_state(struct fallback_dispatch *dispatch,
 
 	/* Buttons and keys */
 	if (dispatch->pending_event & EVDEV_KEY) {
-		bool want_debounce = false;
-		for (unsigned int code = 0; code <= KEY_MAX; code++) {
-			if (!hw_key_has_changed(dispatch, code))
-				continue;
+		unsigned int code;
 
-			if (get_key_type(code) == KEY_TYPE_BUTTON) {
-				want_debounce = true;
-				break;
-			}
-		}
-
-		if (want_debounce)
+		if (hw_key_get_changed(dispatch,
+				       dispatch->button_mask,
+				       &code,
+				       1) > 0)
 			fallback_debounce_handle_state(dispatch, time);
 
 		hw_key_update_last_state(dispatch);
@@ -902,6 +1088,14 @@ fallback_interface_process(struct evdev_dispatch *evdev_dispatch,
 		fallback_process_switch(dispatch, device, event, time);
 		break;
 	case EV_SYN:
+		if (dispatch->mt.protocol_a.enabled) {
+			if (event->code == SYN_MT_REPORT) {
+				fallback_protocol_a_end_contact(dispatch);
+				break;
+			}
+			if (event->code == SYN_REPORT)
+				fallback_protocol_a_assign_slots(dispatch);
+		}
 		fallback_handle_state(dispatch, device, time);
 		break;
 	}
@@ -920,6 +1114,11 @@ release_touches(struct fallback_dispatch *dispatch,
 	for (idx = 0; idx < dispatch->mt.slots_len; idx++) {
 		struct mt_slot *slot = &dispatch->mt.slots[idx];
 
+		if (dispatch->mt.protocol_a.enabled) {
+			slot->state = SLOT_STATE_NONE;
+			dispatch->mt.protocol_a.tracking_ids[idx] = -1;
+		}
+
 		if (slot->seat_slot == -1)
 			continue;
 
@@ -927,6 +1126,12 @@ release_touches(struct fallback_dispatch *dispatch,
 			need_frame = true;
 	}
 
+	if (dispatch->mt.protocol_a.enabled) {
+		dispatch->mt.protocol_a.ncontacts = 0;
+		dispatch->mt.protocol_a.current.tracking_id = -1;
+		dispatch->mt.protocol_a.have_current = false;
+	}
+
 	if (need_frame)
 		touch_notify_frame(&device->base, time);
 }
@@ -994,7 +1199,7 @@ fallback_return_to_neutral_state(struct fallback_dispatch *dispatch,
 	release_touches(dispatch, device, time);
 	release_pressed_keys(dispatch, device, time);
 	memset(dispatch->hw_key_mask, 0, sizeof(dispatch->hw_key_mask));
-	memset(dispatch->hw_key_mask, 0, sizeof(dispatch->last_hw_key_mask));
+	memset(dispatch->last_hw_key_mask, 0, sizeof(dispatch->last_hw_key_mask));
 }
 
 static void
@@ -1013,7 +1218,6 @@ fallback_interface_remove(struct evdev_dispatch *evdev_dispatch)
 	struct evdev_paired_keyboard *kbd, *tmp;
 
 	libinput_timer_cancel(&dispatch->debounce.timer);
-	libinput_timer_cancel(&dispatch->debounce.timer_short);
 
 	libinput_device_remove_event_listener(&dispatch->tablet_mode.other.listener);
 
@@ -1085,9 +1289,10 @@ fallback_interface_destroy(struct evdev_dispatch *evdev_dispatch)
 	struct fallback_dispatch *dispatch = fallback_dispatch(evdev_dispatch);
 
 	libinput_timer_destroy(&dispatch->debounce.timer);
-	libinput_timer_destroy(&dispatch->debounce.timer_short);
 
+	free(dispatch->debounce.buttons);
 	free(dispatch->mt.slots);
+	free(dispatch->mt.dirty_slots);
 	free(dispatch);
 }
 
@@ -1350,7 +1555,7 @@ fallback_init_rotation(struct fallback_dispatch *dispatch,
 	device->base.config.rotation = &dispatch->rotation.config;
 }
 
-static inline int
+static inline void
 fallback_dispatch_init_slots(struct fallback_dispatch *dispatch,
 			     struct evdev_device *device)
 {
@@ -1363,20 +1568,31 @@ fallback_dispatch_init_slots(struct fallback_dispatch *dispatch,
 	if (evdev_is_fake_mt_device(device) ||
 	    !libevdev_has_event_code(evdev, EV_ABS, ABS_MT_POSITION_X) ||
 	    !libevdev_has_event_code(evdev, EV_ABS, ABS_MT_POSITION_Y))
-		 return 0;
+		 return;
 
-	/* We only handle the slotted Protocol B in libinput.
-	   Devices with ABS_MT_POSITION_* but not ABS_MT_SLOT
-	   require mtdev for conversion. */
-	if (evdev_need_mtdev(device)) {
-		device->mtdev = mtdev_new_open(device->fd);
-		if (!device->mtdev)
-			return -1;
+	/* Devices with ABS_MT_POSITION_* but not ABS_MT_SLOT use
+	   Protocol A, we convert their contacts to slots ourselves.
+	   Builds with mtdev let mtdev do the conversion instead and
+	   use our own tracking only if mtdev fails. */
+	if (evdev_is_protocol_a_device(device)) {
+		num_slots = PROTOCOL_A_NUM_SLOTS;
+		active_slot = 0;
 
-		/* pick 10 slots as default for type A
-		   devices. */
-		num_slots = 10;
-		active_slot = device->mtdev->caps.slot.value;
+#if HAVE_MTDEV
+		device->mtdev = mtdev_new_open(device->fd);
+		if (device->mtdev)
+			active_slot = device->mtdev->caps.slot.value;
+		else
+			evdev_log_info(device,
+				       "mtdev failed to initialize, using built-in contact tracking\n");
+#endif
+
+		if (!device->mtdev) {
+			dispatch->mt.protocol_a.enabled = true;
+			dispatch->mt.protocol_a.current.tracking_id = -1;
+			for (slot = 0; slot < num_slots; ++slot)
+				dispatch->mt.protocol_a.tracking_ids[slot] = -1;
+		}
 	} else {
 		num_slots = libevdev_get_num_slots(device->evdev);
 		active_slot = libevdev_get_current_slot(evdev);
@@ -1387,7 +1603,7 @@ fallback_dispatch_init_slots(struct fallback_dispatch *dispatch,
 	for (slot = 0; slot < num_slots; ++slot) {
 		slots[slot].seat_slot = -1;
 
-		if (evdev_need_mtdev(device))
+		if (evdev_is_protocol_a_device(device))
 			continue;
 
 		slots[slot].point.x = libevdev_get_slot_value(evdev,
@@ -1399,6 +1615,8 @@ fallback_dispatch_init_slots(struct fallback_dispatch *dispatch,
 	}
 	dispatch->mt.slots = slots;
 	dispatch->mt.slots_len = num_slots;
+	dispatch->mt.dirty_slots = zalloc(NLONGS(num_slots) *
+					  sizeof(*dispatch->mt.dirty_slots));
 	dispatch->mt.slot = active_slot;
 
 	if (device->abs.absinfo_x->fuzz || device->abs.absinfo_y->fuzz) {
@@ -1406,8 +1624,6 @@ fallback_dispatch_init_slots(struct fallback_dispatch *dispatch,
 		dispatch->mt.hysteresis_margin.x = device->abs.absinfo_x->fuzz/2;
 		dispatch->mt.hysteresis_margin.y = device->abs.absinfo_y->fuzz/2;
 	}
-
-	return 0;
 }
 
 static inline void
@@ -1432,6 +1648,16 @@ fallback_dispatch_init_abs(struct fallback_dispatch *dispatch,
 	evdev_device_init_abs_range_warnings(device);
 }
 
+static inline void
+fallback_dispatch_init_keys(struct fallback_dispatch *dispatch,
+			    struct evdev_device *device)
+{
+	for (unsigned int code = 0; code <= KEY_MAX; code++) {
+		if (get_key_type(code) == KEY_TYPE_BUTTON)
+			long_set_bit(dispatch->button_mask, code);
+	}
+}
+
 static inline void
 fallback_dispatch_init_switch(struct fallback_dispatch *dispatch,
 			      struct evdev_device *device)
@@ -1470,10 +1696,8 @@ fallback_dispatch_create(struct libinput_device *libinput_device)
 
 	fallback_dispatch_init_rel(dispatch, device);
 	fallback_dispatch_init_abs(dispatch, device);
-	if (fallback_dispatch_init_slots(dispatch, device) == -1) {
-		free(dispatch);
-		return NULL;
-	}
+	fallback_dispatch_init_keys(dispatch, device);
+	fallback_dispatch_init_slots(dispatch, device);
 
 	fallback_dispatch_init_switch(dispatch, device);
 
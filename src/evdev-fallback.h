@@ -45,6 +45,23 @@ enum debounce_state {
 	DEBOUNCE_STATE_DISABLED = 999,
 };
 
+struct debounce_button {
+	unsigned int code;
+	enum debounce_state state;
+	uint64_t time;
+	/* timeouts in us, 0 if unset */
+	uint64_t timeout;
+	uint64_t timeout_short;
+};
+
+/* Protocol A devices don't announce a slot count, pick 10 */
+#define PROTOCOL_A_NUM_SLOTS 10
+
+struct mt_contact {
+	struct device_coords point;
+	int32_t tracking_id;
+};
+
 struct fallback_dispatch {
 	struct evdev_dispatch base;
 	struct evdev_device *device;
@@ -67,8 +84,22 @@ struct fallback_dispatch {
 		int slot;
 		struct mt_slot *slots;
 		size_t slots_len;
+		/* bitmask of the slots changed in the current frame */
+		unsigned long *dirty_slots;
 		bool want_hysteresis;
 		struct device_coords hysteresis_margin;
+
+		/* Protocol A devices: the contacts of the current frame,
+		 * assigned to slots on SYN_REPORT */
+		struct {
+			bool enabled;
+			struct mt_contact contacts[PROTOCOL_A_NUM_SLOTS];
+			size_t ncontacts;
+			struct mt_contact current;
+			bool have_current;
+			/* tracking ID of the contact in each slot */
+			int32_t tracking_ids[PROTOCOL_A_NUM_SLOTS];
+		} protocol_a;
 	} mt;
 
 	struct device_coords rel;
@@ -91,6 +122,8 @@ struct fallback_dispatch {
 	 * the kernel. */
 	unsigned long hw_key_mask[NLONGS(KEY_CNT)];
 	unsigned long last_hw_key_mask[NLONGS(KEY_CNT)];
+	/* Bitmask of all codes of KEY_TYPE_BUTTON */
+	unsigned long button_mask[NLONGS(KEY_CNT)];
 
 	enum evdev_event_type pending_event;
 
@@ -99,11 +132,12 @@ struct fallback_dispatch {
 	bool ignore_events;
 
 	struct {
-		unsigned int button_code;
-		uint64_t button_time;
+		/* One entry for each button the device has, sorted by
+		 * code */
+		struct debounce_button *buttons;
+		size_t nbuttons;
+		/* shared by all buttons, set to the earliest timeout */
 		struct libinput_timer timer;
-		struct libinput_timer timer_short;
-		enum debounce_state state;
 		bool spurious_enabled;
 	} debounce;
 
@@ -177,11 +211,40 @@ hw_set_key_down(struct fallback_dispatch *dispatch, int code, int pressed)
 	long_set_bit_state(dispatch->hw_key_mask, code, pressed);
 }
 
-static inline bool
-hw_key_has_changed(struct fallback_dispatch *dispatch, int code)
+/**
+ * Fill codes with up to max key codes that changed state since the last
+ * frame and are set in mask. The key masks are compared one long at a
+ * time so the cost depends on the number of changed keys, not on the
+ * size of the key space.
+ *
+ * @return the number of codes filled in
+ */
+static inline size_t
+hw_key_get_changed(struct fallback_dispatch *dispatch,
+		   const unsigned long *mask,
+		   unsigned int *codes,
+		   size_t max)
 {
-	return long_bit_is_set(dispatch->hw_key_mask, code) !=
-		long_bit_is_set(dispatch->last_hw_key_mask, code);
+	size_t nchanged = 0;
+
+	for (size_t i = 0; i < ARRAY_LENGTH(dispatch->hw_key_mask); i++) {
+		unsigned long changed;
+
+		changed = dispatch->hw_key_mask[i] ^
+			  dispatch->last_hw_key_mask[i];
+		changed &= mask[i];
+
+		while (changed != 0) {
+			if (nchanged == max)
+				return nchanged;
+
+			codes[nchanged++] = i * LONG_BITS +
+					    __builtin_ctzl(changed);
+			changed &= changed - 1;
+		}
+	}
+
+	return nchanged;
 }
 
 static inline void
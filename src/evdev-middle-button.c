@@ -28,6 +28,9 @@
 #include "evdev.h"
 
 #define MIDDLEBUTTON_TIMEOUT ms2us(50)
+#define MIDDLEBUTTON_ADAPTIVE_MIN_TIMEOUT ms2us(20)
+#define MIDDLEBUTTON_ADAPTIVE_MARGIN ms2us(10)
+#define MIDDLEBUTTON_ADAPTIVE_MIN_SAMPLES 8
 
 /*****************************************
  * BEFORE YOU EDIT THIS FILE, look at the state diagram in
@@ -91,8 +94,63 @@ middlebutton_state_error(struct evdev_device *device,
 static void
 middlebutton_timer_set(struct evdev_device *device, uint64_t now)
 {
-	libinput_timer_set(&device->middlebutton.timer,
-			   now + MIDDLEBUTTON_TIMEOUT);
+	uint64_t timeout = adaptive_timeout_get(&device->middlebutton.adaptive);
+
+	libinput_timer_set(&device->middlebutton.timer, now + timeout);
+}
+
+static void
+middlebutton_adaptive_log(struct evdev_device *device)
+{
+	evdev_log_debug(device,
+			"middlebutton: adaptive timeout is %ums after %u samples\n",
+			(unsigned int)us2ms(device->middlebutton.adaptive.timeout),
+			device->middlebutton.adaptive.ngaps);
+}
+
+/* The gap between the first and the second button press of an
+ * emulated middle click */
+static void
+middlebutton_adaptive_add_gap(struct evdev_device *device, uint64_t gap)
+{
+	if (adaptive_timeout_add_gap(&device->middlebutton.adaptive, gap))
+		middlebutton_adaptive_log(device);
+}
+
+/* The other button pressed shortly after a press committed by a
+ * shortened timeout was meant as middle click, learn from it */
+static void
+middlebutton_adaptive_check_expired(struct evdev_device *device,
+				    uint64_t now)
+{
+	if (adaptive_timeout_check_expired(&device->middlebutton.adaptive, now))
+		middlebutton_adaptive_log(device);
+}
+
+static void
+middlebutton_adaptive_timeout_expired(struct evdev_device *device)
+{
+	adaptive_timeout_expired(&device->middlebutton.adaptive,
+				 device->middlebutton.first_event_time);
+}
+
+/* Track how long a left/right press was held back before it was sent */
+static void
+middlebutton_update_latency(struct evdev_device *device, uint64_t now)
+{
+	uint64_t delay = now - device->middlebutton.first_event_time;
+
+	device->middlebutton.latency.count++;
+	device->middlebutton.latency.total += delay;
+	device->middlebutton.latency.max =
+		max(device->middlebutton.latency.max, delay);
+
+	evdev_log_debug(device,
+			"middlebutton: press delayed by %ums (avg %ums, max %ums)\n",
+			(unsigned int)us2ms(delay),
+			(unsigned int)us2ms(device->middlebutton.latency.total /
+					    device->middlebutton.latency.count),
+			(unsigned int)us2ms(device->middlebutton.latency.max));
 }
 
 static void
@@ -175,12 +233,15 @@ evdev_middlebutton_ldown_handle_event(struct evdev_device *device,
 		middlebutton_state_error(device, event);
 		break;
 	case MIDDLEBUTTON_EVENT_R_DOWN:
+		middlebutton_adaptive_add_gap(device,
+					      time - device->middlebutton.first_event_time);
 		middlebutton_post_event(device, time,
 					BTN_MIDDLE,
 					LIBINPUT_BUTTON_STATE_PRESSED);
 		middlebutton_set_state(device, MIDDLEBUTTON_MIDDLE, time);
 		break;
 	case MIDDLEBUTTON_EVENT_OTHER:
+		middlebutton_update_latency(device, time);
 		middlebutton_post_event(device, time,
 					BTN_LEFT,
 					LIBINPUT_BUTTON_STATE_PRESSED);
@@ -192,6 +253,7 @@ evdev_middlebutton_ldown_handle_event(struct evdev_device *device,
 		middlebutton_state_error(device, event);
 		break;
 	case MIDDLEBUTTON_EVENT_L_UP:
+		middlebutton_update_latency(device, time);
 		middlebutton_post_event(device,
 					device->middlebutton.first_event_time,
 					BTN_LEFT,
@@ -202,6 +264,8 @@ evdev_middlebutton_ldown_handle_event(struct evdev_device *device,
 		middlebutton_set_state(device, MIDDLEBUTTON_IDLE, time);
 		break;
 	case MIDDLEBUTTON_EVENT_TIMEOUT:
+		middlebutton_update_latency(device, time);
+		middlebutton_adaptive_timeout_expired(device);
 		middlebutton_post_event(device,
 					device->middlebutton.first_event_time,
 					BTN_LEFT,
@@ -225,6 +289,8 @@ evdev_middlebutton_rdown_handle_event(struct evdev_device *device,
 {
 	switch (event) {
 	case MIDDLEBUTTON_EVENT_L_DOWN:
+		middlebutton_adaptive_add_gap(device,
+					      time - device->middlebutton.first_event_time);
 		middlebutton_post_event(device, time,
 					BTN_MIDDLE,
 					LIBINPUT_BUTTON_STATE_PRESSED);
@@ -234,6 +300,7 @@ evdev_middlebutton_rdown_handle_event(struct evdev_device *device,
 		middlebutton_state_error(device, event);
 		break;
 	case MIDDLEBUTTON_EVENT_OTHER:
+		middlebutton_update_latency(device, time);
 		middlebutton_post_event(device,
 					device->middlebutton.first_event_time,
 					BTN_RIGHT,
@@ -243,6 +310,7 @@ evdev_middlebutton_rdown_handle_event(struct evdev_device *device,
 				       time);
 		return 0;
 	case MIDDLEBUTTON_EVENT_R_UP:
+		middlebutton_update_latency(device, time);
 		middlebutton_post_event(device,
 					device->middlebutton.first_event_time,
 					BTN_RIGHT,
@@ -256,6 +324,8 @@ evdev_middlebutton_rdown_handle_event(struct evdev_device *device,
 		middlebutton_state_error(device, event);
 		break;
 	case MIDDLEBUTTON_EVENT_TIMEOUT:
+		middlebutton_update_latency(device, time);
+		middlebutton_adaptive_timeout_expired(device);
 		middlebutton_post_event(device,
 					device->middlebutton.first_event_time,
 					BTN_RIGHT,
@@ -393,6 +463,8 @@ evdev_middlebutton_passthrough_handle_event(struct evdev_device *device,
 	switch (event) {
 	case MIDDLEBUTTON_EVENT_L_DOWN:
 	case MIDDLEBUTTON_EVENT_R_DOWN:
+		middlebutton_adaptive_check_expired(device, time);
+		return 0;
 	case MIDDLEBUTTON_EVENT_OTHER:
 	case MIDDLEBUTTON_EVENT_R_UP:
 	case MIDDLEBUTTON_EVENT_L_UP:
@@ -401,6 +473,7 @@ evdev_middlebutton_passthrough_handle_event(struct evdev_device *device,
 		middlebutton_state_error(device, event);
 		break;
 	case MIDDLEBUTTON_EVENT_ALL_UP:
+		adaptive_timeout_clear_expired(&device->middlebutton.adaptive);
 		middlebutton_set_state(device, MIDDLEBUTTON_IDLE, time);
 		break;
 	}
@@ -696,6 +769,42 @@ evdev_middlebutton_get_default(struct libinput_device *device)
 			LIBINPUT_CONFIG_MIDDLE_EMULATION_DISABLED;
 }
 
+static enum libinput_config_status
+evdev_middlebutton_set_adaptive_timeout(struct libinput_device *device,
+					enum libinput_config_middle_emulation_adaptive_timeout_state enable)
+{
+	struct evdev_device *evdev = evdev_device(device);
+
+	switch (enable) {
+	case LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED:
+		evdev->middlebutton.adaptive.enabled = true;
+		break;
+	case LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED:
+		evdev->middlebutton.adaptive.enabled = false;
+		break;
+	default:
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+	}
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static enum libinput_config_middle_emulation_adaptive_timeout_state
+evdev_middlebutton_get_adaptive_timeout(struct libinput_device *device)
+{
+	struct evdev_device *evdev = evdev_device(device);
+
+	return evdev->middlebutton.adaptive.enabled ?
+			LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED :
+			LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED;
+}
+
+static enum libinput_config_middle_emulation_adaptive_timeout_state
+evdev_middlebutton_get_default_adaptive_timeout(struct libinput_device *device)
+{
+	return LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED;
+}
+
 void
 evdev_init_middlebutton(struct evdev_device *device,
 			bool enable,
@@ -715,6 +824,11 @@ evdev_init_middlebutton(struct evdev_device *device,
 	device->middlebutton.enabled_default = enable;
 	device->middlebutton.want_enabled = enable;
 	device->middlebutton.enabled = enable;
+	adaptive_timeout_init(&device->middlebutton.adaptive,
+			      MIDDLEBUTTON_ADAPTIVE_MIN_TIMEOUT,
+			      MIDDLEBUTTON_TIMEOUT,
+			      MIDDLEBUTTON_ADAPTIVE_MARGIN,
+			      MIDDLEBUTTON_ADAPTIVE_MIN_SAMPLES);
 
 	if (!want_config)
 		return;
@@ -723,5 +837,8 @@ evdev_init_middlebutton(struct evdev_device *device,
 	device->middlebutton.config.set = evdev_middlebutton_set;
 	device->middlebutton.config.get = evdev_middlebutton_get;
 	device->middlebutton.config.get_default = evdev_middlebutton_get_default;
+	device->middlebutton.config.set_adaptive_timeout = evdev_middlebutton_set_adaptive_timeout;
+	device->middlebutton.config.get_adaptive_timeout = evdev_middlebutton_get_adaptive_timeout;
+	device->middlebutton.config.get_default_adaptive_timeout = evdev_middlebutton_get_default_adaptive_timeout;
 	device->base.config.middle_emulation = &device->middlebutton.config;
 }
@@ -498,6 +498,9 @@ tp_button_handle_timeout(uint64_t now, void *data)
 {
 	struct tp_touch *t = data;
 
+	/* Resampled motion is older than anything the timeout sends */
+	tp_gesture_flush_resample(t->tp, now);
+
 	tp_button_handle_event(t->tp, t, BUTTON_EVENT_TIMEOUT, now);
 }
 
@@ -25,6 +25,7 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include <limits.h>
 
 #include "evdev-mt-touchpad.h"
@@ -32,6 +33,7 @@
 #define DEFAULT_GESTURE_SWITCH_TIMEOUT ms2us(100)
 #define DEFAULT_GESTURE_2FG_SCROLL_TIMEOUT ms2us(150)
 #define DEFAULT_GESTURE_2FG_PINCH_TIMEOUT ms2us(75)
+#define TP_RESAMPLE_MAX_SAMPLES 16U
 
 static inline const char*
 gesture_state_to_str(enum tp_gesture_state state)
@@ -127,11 +129,98 @@ tp_gesture_start(struct tp_dispatch *tp, uint64_t time)
 	tp->gesture.started = true;
 }
 
+static unsigned int
+tp_resample_nsamples(struct tp_dispatch *tp)
+{
+	double report_interval = tp->device->report_rate.interval;
+	double interval;
+	unsigned int nsamples;
+
+	if (tp->resample.rate == 0 || report_interval == 0.0)
+		return 1;
+
+	/* Spread the motion across the report interval, the last sample
+	 * goes out before the next frame is due */
+	interval = (double)s2us(1) / tp->resample.rate;
+	nsamples = ceil(report_interval / interval);
+
+	return min(max(nsamples, 1U), TP_RESAMPLE_MAX_SAMPLES);
+}
+
+static void
+tp_resample_post(struct tp_dispatch *tp, uint64_t time, unsigned int count)
+{
+	struct normalized_coords delta;
+	struct device_float_coords unaccel;
+	uint64_t delay = time - tp->resample.frame_time;
+
+	delta.x = tp->resample.delta.x * count;
+	delta.y = tp->resample.delta.y * count;
+	unaccel.x = tp->resample.unaccel.x * count;
+	unaccel.y = tp->resample.unaccel.y * count;
+
+	pointer_notify_motion(&tp->device->base, time, &delta, &unaccel);
+
+	tp->resample.pending -= count;
+	tp->resample.stats.events++;
+	tp->resample.stats.total_delay += delay;
+	tp->resample.stats.max_delay = max(tp->resample.stats.max_delay,
+					   delay);
+}
+
+static void
+tp_resample_timeout(uint64_t now, void *data)
+{
+	struct tp_dispatch *tp = data;
+
+	if (tp->resample.pending == 0)
+		return;
+
+	tp_resample_post(tp, now, 1);
+
+	if (tp->resample.pending > 0) {
+		tp->resample.next_time += s2us(1) / tp->resample.rate;
+		libinput_timer_set_flags(&tp->resample.timer,
+					 tp->resample.next_time,
+					 TIMER_FLAG_ALLOW_NEGATIVE);
+	}
+}
+
+void
+tp_gesture_flush_resample(struct tp_dispatch *tp, uint64_t time)
+{
+	if (tp->resample.pending == 0)
+		return;
+
+	libinput_timer_cancel(&tp->resample.timer);
+	tp_resample_post(tp, time, tp->resample.pending);
+}
+
+static void
+tp_resample_log_stats(struct tp_dispatch *tp)
+{
+	if (tp->resample.stats.frames == 0)
+		return;
+
+	evdev_log_debug(tp->device,
+			"resample: %u frames sent as %u events, "
+			"added latency avg %" PRIu64 "us max %" PRIu64 "us\n",
+			tp->resample.stats.frames,
+			tp->resample.stats.events,
+			tp->resample.stats.total_delay /
+				tp->resample.stats.events,
+			tp->resample.stats.max_delay);
+
+	memset(&tp->resample.stats, 0, sizeof(tp->resample.stats));
+}
+
 static void
 tp_gesture_post_pointer_motion(struct tp_dispatch *tp, uint64_t time)
 {
 	struct device_float_coords raw;
 	struct normalized_coords delta;
+	struct device_float_coords unaccel;
+	unsigned int nsamples;
 
 	/* When a clickpad is clicked, combine motion of all active touches */
 	if (tp->buttons.is_clickpad && tp->buttons.state)
@@ -141,15 +230,37 @@ tp_gesture_post_pointer_motion(struct tp_dispatch *tp, uint64_t time)
 
 	delta = tp_filter_motion(tp, &raw, time);
 
-	if (!normalized_is_zero(delta) || !device_float_is_zero(raw)) {
-		struct device_float_coords unaccel;
+	if (normalized_is_zero(delta) && device_float_is_zero(raw))
+		return;
+
+	unaccel = tp_scale_to_xaxis(tp, raw);
 
-		unaccel = tp_scale_to_xaxis(tp, raw);
+	nsamples = tp_resample_nsamples(tp);
+	if (nsamples == 1) {
 		pointer_notify_motion(&tp->device->base,
 				      time,
 				      &delta,
 				      &unaccel);
+		return;
 	}
+
+	/* Split the motion into equal parts, send the first one now and
+	 * the rest at the resample rate until the next frame */
+	tp->resample.delta.x = delta.x / nsamples;
+	tp->resample.delta.y = delta.y / nsamples;
+	tp->resample.unaccel.x = unaccel.x / nsamples;
+	tp->resample.unaccel.y = unaccel.y / nsamples;
+	tp->resample.pending = nsamples;
+	tp->resample.frame_time = time;
+	tp->resample.stats.frames++;
+
+	tp_resample_post(tp, time, 1);
+
+	tp->resample.next_time = time + s2us(1) / tp->resample.rate;
+	/* The frame may be processed late, so may the timer */
+	libinput_timer_set_flags(&tp->resample.timer,
+				 tp->resample.next_time,
+				 TIMER_FLAG_ALLOW_NEGATIVE);
 }
 
 static unsigned int
@@ -202,23 +313,52 @@ tp_gesture_get_direction(struct tp_dispatch *tp, struct tp_touch *touch,
 	return phys_get_direction(mm);
 }
 
+/**
+ * Update the cached directions of the two gesture touches. A touch that
+ * didn't change in this frame keeps its direction, so this is cheap for
+ * 3+ finger gestures where only some of the fingers move in each frame.
+ * After skipped frames, all directions are recalculated.
+ */
 static void
-tp_gesture_get_pinch_info(struct tp_dispatch *tp,
-			  double *distance,
-			  double *angle,
-			  struct device_float_coords *center)
+tp_gesture_update_directions(struct tp_dispatch *tp)
+{
+	unsigned int nfingers = tp->gesture.finger_count;
+
+	for (int i = 0; i < 2; i++) {
+		struct tp_touch *t = tp->gesture.touches[i];
+
+		if (t->dirty || tp->gesture.cache_stale)
+			t->gesture.direction = tp_gesture_get_direction(tp,
+									t,
+									nfingers);
+	}
+}
+
+/**
+ * Update the cached pinch geometry of the two gesture touches. If neither
+ * touch changed in this frame, the geometry is unchanged and we can skip
+ * the recalculation unless force is set or frames were skipped.
+ */
+static void
+tp_gesture_update_geometry(struct tp_dispatch *tp, bool force)
 {
 	struct normalized_coords normalized;
 	struct device_float_coords delta;
 	struct tp_touch *first = tp->gesture.touches[0],
 			*second = tp->gesture.touches[1];
 
+	if (!force && !tp->gesture.cache_stale &&
+	    !first->dirty && !second->dirty)
+		return;
+
 	delta = device_delta(first->point, second->point);
 	normalized = tp_normalize_delta(tp, delta);
-	*distance = normalized_length(normalized);
-	*angle = atan2(normalized.y, normalized.x) * 180.0 / M_PI;
+	tp->gesture.geometry.distance = normalized_length(normalized);
+	tp->gesture.geometry.angle = atan2(normalized.y, normalized.x) *
+					180.0 / M_PI;
 
-	*center = device_average(first->point, second->point);
+	tp->gesture.geometry.center = device_average(first->point,
+						     second->point);
 }
 
 static void
@@ -236,6 +376,22 @@ tp_gesture_set_scroll_buildup(struct tp_dispatch *tp)
 	tp->device->scroll.buildup = tp_normalize_delta(tp, average);
 }
 
+static inline bool
+tp_gesture_events_wanted(struct tp_dispatch *tp)
+{
+	struct libinput *li = tp_libinput_context(tp);
+	enum libinput_event_type type;
+
+	for (type = LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN;
+	     type <= LIBINPUT_EVENT_GESTURE_PINCH_END;
+	     type++) {
+		if (!libinput_event_type_is_disabled(li, type))
+			return true;
+	}
+
+	return false;
+}
+
 static enum tp_gesture_state
 tp_gesture_handle_state_none(struct tp_dispatch *tp, uint64_t time)
 {
@@ -248,7 +404,9 @@ tp_gesture_handle_state_none(struct tp_dispatch *tp, uint64_t time)
 	if (ntouches < 2)
 		return GESTURE_STATE_NONE;
 
-	if (!tp->gesture.enabled) {
+	/* If the caller doesn't want swipe or pinch events, skip their
+	 * detection and only handle two-finger scrolling */
+	if (!tp->gesture.enabled || !tp_gesture_events_wanted(tp)) {
 		if (ntouches == 2)
 			return GESTURE_STATE_SCROLL;
 		else
@@ -290,7 +448,9 @@ tp_gesture_handle_state_none(struct tp_dispatch *tp, uint64_t time)
 
 	tp->gesture.initial_time = time;
 	first->gesture.initial = first->point;
+	first->gesture.direction = UNDEFINED_DIRECTION;
 	second->gesture.initial = second->point;
+	second->gesture.direction = UNDEFINED_DIRECTION;
 	tp->gesture.touches[0] = first;
 	tp->gesture.touches[1] = second;
 
@@ -316,10 +476,10 @@ tp_gesture_same_directions(int dir1, int dir2)
 static inline void
 tp_gesture_init_pinch(struct tp_dispatch *tp)
 {
-	tp_gesture_get_pinch_info(tp,
-				  &tp->gesture.initial_distance,
-				  &tp->gesture.angle,
-				  &tp->gesture.center);
+	tp_gesture_update_geometry(tp, true);
+	tp->gesture.initial_distance = tp->gesture.geometry.distance;
+	tp->gesture.angle = tp->gesture.geometry.angle;
+	tp->gesture.center = tp->gesture.geometry.center;
 	tp->gesture.prev_scale = 1.0;
 }
 
@@ -367,8 +527,9 @@ tp_gesture_handle_state_unknown(struct tp_dispatch *tp, uint64_t time)
 	}
 
 	/* Else wait for both fingers to have moved */
-	dir1 = tp_gesture_get_direction(tp, first, tp->gesture.finger_count);
-	dir2 = tp_gesture_get_direction(tp, second, tp->gesture.finger_count);
+	tp_gesture_update_directions(tp);
+	dir1 = first->gesture.direction;
+	dir2 = second->gesture.direction;
 	if (dir1 == UNDEFINED_DIRECTION || dir2 == UNDEFINED_DIRECTION)
 		return GESTURE_STATE_UNKNOWN;
 
@@ -444,7 +605,10 @@ tp_gesture_handle_state_pinch(struct tp_dispatch *tp, uint64_t time)
 	struct device_float_coords center, fdelta;
 	struct normalized_coords delta, unaccel;
 
-	tp_gesture_get_pinch_info(tp, &distance, &angle, &center);
+	tp_gesture_update_geometry(tp, false);
+	distance = tp->gesture.geometry.distance;
+	angle = tp->gesture.geometry.angle;
+	center = tp->gesture.geometry.center;
 
 	scale = distance / tp->gesture.initial_distance;
 
@@ -520,9 +684,12 @@ tp_gesture_post_events(struct tp_dispatch *tp, uint64_t time)
 		tp->gesture.finger_count_pending = 0;
 	}
 
-	/* Don't send events when we're unsure in which mode we are */
-	if (tp->gesture.finger_count_pending)
+	/* Don't send events when we're unsure in which mode we are. The
+	 * touches keep moving, so the cached geometry goes stale */
+	if (tp->gesture.finger_count_pending) {
+		tp->gesture.cache_stale = true;
 		return;
+	}
 
 	switch (tp->gesture.finger_count) {
 	case 1:
@@ -535,6 +702,8 @@ tp_gesture_post_events(struct tp_dispatch *tp, uint64_t time)
 		tp_gesture_post_gesture(tp, time);
 		break;
 	}
+
+	tp->gesture.cache_stale = false;
 }
 
 void
@@ -624,6 +793,7 @@ tp_gesture_handle_state(struct tp_dispatch *tp, uint64_t time)
 	if (active_touches != tp->gesture.finger_count) {
 		/* If all fingers are lifted immediately end the gesture */
 		if (active_touches == 0) {
+			tp_resample_log_stats(tp);
 			tp_gesture_stop(tp, time);
 			tp->gesture.finger_count = 0;
 			tp->gesture.finger_count_pending = 0;
@@ -642,6 +812,62 @@ tp_gesture_handle_state(struct tp_dispatch *tp, uint64_t time)
 	}
 }
 
+static int
+tp_resample_config_is_available(struct libinput_device *device)
+{
+	return 1;
+}
+
+static enum libinput_config_status
+tp_resample_config_set_rate(struct libinput_device *device,
+			    unsigned int rate)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tp_dispatch *tp = (struct tp_dispatch*)evdev->dispatch;
+
+	tp_gesture_flush_resample(tp, libinput_now(tp_libinput_context(tp)));
+	tp->resample.rate = rate;
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static unsigned int
+tp_resample_config_get_rate(struct libinput_device *device)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tp_dispatch *tp = (struct tp_dispatch*)evdev->dispatch;
+
+	return tp->resample.rate;
+}
+
+static unsigned int
+tp_resample_config_get_default_rate(struct libinput_device *device)
+{
+	return 0;
+}
+
+static void
+tp_init_resample(struct tp_dispatch *tp)
+{
+	char timer_name[64];
+
+	tp->resample.config.is_available = tp_resample_config_is_available;
+	tp->resample.config.set_rate = tp_resample_config_set_rate;
+	tp->resample.config.get_rate = tp_resample_config_get_rate;
+	tp->resample.config.get_default_rate = tp_resample_config_get_default_rate;
+	tp->resample.rate = 0;
+	tp->device->base.config.resample = &tp->resample.config;
+
+	snprintf(timer_name,
+		 sizeof(timer_name),
+		 "%s resample",
+		 evdev_device_get_sysname(tp->device));
+	libinput_timer_init(&tp->resample.timer,
+			    tp_libinput_context(tp),
+			    timer_name,
+			    tp_resample_timeout, tp);
+}
+
 void
 tp_init_gesture(struct tp_dispatch *tp)
 {
@@ -662,10 +888,14 @@ tp_init_gesture(struct tp_dispatch *tp)
 			    tp_libinput_context(tp),
 			    timer_name,
 			    tp_gesture_finger_count_switch_timeout, tp);
+
+	tp_init_resample(tp);
 }
 
 void
 tp_remove_gesture(struct tp_dispatch *tp)
 {
 	libinput_timer_cancel(&tp->gesture.finger_count_switch_timer);
+	libinput_timer_cancel(&tp->resample.timer);
+	tp->resample.pending = 0;
 }
@@ -35,6 +35,9 @@
 
 #define DEFAULT_TAP_TIMEOUT_PERIOD ms2us(180)
 #define DEFAULT_DRAG_TIMEOUT_PERIOD ms2us(300)
+#define ADAPTIVE_TAP_MIN_TIMEOUT ms2us(100)
+#define ADAPTIVE_TAP_MARGIN ms2us(30)
+#define ADAPTIVE_TAP_MIN_SAMPLES 8
 #define DEFAULT_TAP_MOVE_THRESHOLD 1.3 /* mm */
 
 enum tap_event {
@@ -148,6 +151,41 @@ tp_tap_set_timer(struct tp_dispatch *tp, uint64_t time)
 	libinput_timer_set(&tp->tap.timer, time + DEFAULT_TAP_TIMEOUT_PERIOD);
 }
 
+static void
+tp_tap_adaptive_log(struct tp_dispatch *tp)
+{
+	evdev_log_debug(tp->device,
+			"tap: adaptive timeout is %ums after %u samples\n",
+			(unsigned int)us2ms(tp->tap.adaptive.timeout),
+			tp->tap.adaptive.ngaps);
+}
+
+/* The gap between a tap's release and the next touch down that turned
+ * it into a double-tap or a drag */
+static void
+tp_tap_adaptive_add_gap(struct tp_dispatch *tp, uint64_t gap)
+{
+	if (adaptive_timeout_add_gap(&tp->tap.adaptive, gap))
+		tp_tap_adaptive_log(tp);
+}
+
+/* A touch shortly after a tap whose shortened timeout expired was meant
+ * as double-tap or drag, learn from it */
+static void
+tp_tap_adaptive_check_expired(struct tp_dispatch *tp, uint64_t time)
+{
+	if (adaptive_timeout_check_expired(&tp->tap.adaptive, time))
+		tp_tap_adaptive_log(tp);
+}
+
+static void
+tp_tap_set_tapped_timer(struct tp_dispatch *tp, uint64_t time)
+{
+	uint64_t timeout = adaptive_timeout_get(&tp->tap.adaptive);
+
+	libinput_timer_set(&tp->tap.timer, time + timeout);
+}
+
 static void
 tp_tap_set_drag_timer(struct tp_dispatch *tp, uint64_t time)
 {
@@ -167,6 +205,7 @@ tp_tap_idle_handle_event(struct tp_dispatch *tp,
 {
 	switch (event) {
 	case TAP_EVENT_TOUCH:
+		tp_tap_adaptive_check_expired(tp, time);
 		tp->tap.state = TAP_STATE_TOUCH;
 		tp->tap.saved_press_time = time;
 		tp_tap_set_timer(tp, time);
@@ -212,7 +251,7 @@ tp_tap_touch_handle_event(struct tp_dispatch *tp,
 		if (tp->tap.drag_enabled) {
 			tp->tap.state = TAP_STATE_TAPPED;
 			tp->tap.saved_release_time = time;
-			tp_tap_set_timer(tp, time);
+			tp_tap_set_tapped_timer(tp, time);
 		} else {
 			tp_tap_notify(tp,
 				      time,
@@ -291,6 +330,7 @@ tp_tap_tapped_handle_event(struct tp_dispatch *tp,
 		log_tap_bug(tp, t, event);
 		break;
 	case TAP_EVENT_TOUCH:
+		tp_tap_adaptive_add_gap(tp, time - tp->tap.saved_release_time);
 		tp->tap.state = TAP_STATE_DRAGGING_OR_DOUBLETAP;
 		tp->tap.saved_press_time = time;
 		tp_tap_set_timer(tp, time);
@@ -301,6 +341,11 @@ tp_tap_tapped_handle_event(struct tp_dispatch *tp,
 			      tp->tap.saved_release_time,
 			      1,
 			      LIBINPUT_BUTTON_STATE_RELEASED);
+		evdev_log_debug(tp->device,
+				"tap: button release delayed by %ums\n",
+				(unsigned int)us2ms(time - tp->tap.saved_release_time));
+		adaptive_timeout_expired(&tp->tap.adaptive,
+					 tp->tap.saved_release_time);
 		break;
 	case TAP_EVENT_BUTTON:
 		tp->tap.state = TAP_STATE_DEAD;
@@ -433,7 +478,7 @@ tp_tap_touch2_release_handle_event(struct tp_dispatch *tp,
 		if (tp->tap.drag_enabled) {
 			tp->tap.state = TAP_STATE_TAPPED;
 			tp->tap.saved_release_time = time;
-			tp_tap_set_timer(tp, time);
+			tp_tap_set_tapped_timer(tp, time);
 		} else {
 			tp_tap_notify(tp,
 				      time,
@@ -1106,6 +1151,9 @@ tp_tap_handle_timeout(uint64_t time, void *data)
 	struct tp_dispatch *tp = data;
 	struct tp_touch *t;
 
+	/* Resampled motion is older than anything the timeout sends */
+	tp_gesture_flush_resample(tp, time);
+
 	tp_tap_handle_event(tp, NULL, TAP_EVENT_TIMEOUT, time);
 
 	tp_for_each_touch(tp, t) {
@@ -1309,6 +1357,41 @@ tp_tap_config_get_default_draglock_enabled(struct libinput_device *device)
 	return tp_drag_lock_default(evdev);
 }
 
+static enum libinput_config_status
+tp_tap_config_set_adaptive_timeout_enabled(struct libinput_device *device,
+					   enum libinput_config_tap_adaptive_timeout_state enabled)
+{
+	struct evdev_dispatch *dispatch = evdev_device(device)->dispatch;
+	struct tp_dispatch *tp = tp_dispatch(dispatch);
+
+	tp->tap.adaptive.enabled = enabled;
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static enum libinput_config_tap_adaptive_timeout_state
+tp_tap_config_get_adaptive_timeout_enabled(struct libinput_device *device)
+{
+	struct evdev_dispatch *dispatch = evdev_device(device)->dispatch;
+	struct tp_dispatch *tp = tp_dispatch(dispatch);
+
+	return tp->tap.adaptive.enabled;
+}
+
+static inline enum libinput_config_tap_adaptive_timeout_state
+tp_adaptive_timeout_default(struct evdev_device *device)
+{
+	return LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED;
+}
+
+static enum libinput_config_tap_adaptive_timeout_state
+tp_tap_config_get_default_adaptive_timeout_enabled(struct libinput_device *device)
+{
+	struct evdev_device *evdev = evdev_device(device);
+
+	return tp_adaptive_timeout_default(evdev);
+}
+
 void
 tp_init_tap(struct tp_dispatch *tp)
 {
@@ -1327,6 +1410,9 @@ tp_init_tap(struct tp_dispatch *tp)
 	tp->tap.config.set_draglock_enabled = tp_tap_config_set_draglock_enabled;
 	tp->tap.config.get_draglock_enabled = tp_tap_config_get_draglock_enabled;
 	tp->tap.config.get_default_draglock_enabled = tp_tap_config_get_default_draglock_enabled;
+	tp->tap.config.set_adaptive_timeout_enabled = tp_tap_config_set_adaptive_timeout_enabled;
+	tp->tap.config.get_adaptive_timeout_enabled = tp_tap_config_get_adaptive_timeout_enabled;
+	tp->tap.config.get_default_adaptive_timeout_enabled = tp_tap_config_get_default_adaptive_timeout_enabled;
 	tp->device->base.config.tap = &tp->tap.config;
 
 	tp->tap.state = TAP_STATE_IDLE;
@@ -1335,6 +1421,12 @@ tp_init_tap(struct tp_dispatch *tp)
 	tp->tap.want_map = tp->tap.map;
 	tp->tap.drag_enabled = tp_drag_default(tp->device);
 	tp->tap.drag_lock_enabled = tp_drag_lock_default(tp->device);
+	adaptive_timeout_init(&tp->tap.adaptive,
+			      ADAPTIVE_TAP_MIN_TIMEOUT,
+			      DEFAULT_TAP_TIMEOUT_PERIOD,
+			      ADAPTIVE_TAP_MARGIN,
+			      ADAPTIVE_TAP_MIN_SAMPLES);
+	tp->tap.adaptive.enabled = tp_adaptive_timeout_default(tp->device);
 
 	snprintf(timer_name,
 		 sizeof(timer_name),
@@ -24,9 +24,11 @@
 #include "config.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <math.h>
 #include <stdbool.h>
 #include <limits.h>
+#include <time.h>
 
 #include "quirks.h"
 #include "evdev-mt-touchpad.h"
@@ -873,10 +875,10 @@ tp_palm_detect_move_out_of_edge(struct tp_dispatch *tp,
 }
 
 static inline bool
-tp_palm_detect_multifinger(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
+tp_palm_detect_multifinger(struct tp_dispatch *tp,
+			   struct tp_touch *t,
+			   unsigned int nactive_others)
 {
-	struct tp_touch *other;
-
 	if (tp->nfingers_down < 2)
 		return false;
 
@@ -888,17 +890,7 @@ tp_palm_detect_multifinger(struct tp_dispatch *tp, struct tp_touch *t, uint64_t
 	 * frame the second touch will still be PALM_NONE and thus detected
 	 * here as non-palm touch. This is too niche to worry about for now.
 	 */
-	tp_for_each_touch(tp, other) {
-		if (other == t)
-			continue;
-
-		if (tp_touch_active(tp, other) &&
-		    other->palm.state == PALM_NONE) {
-			return true;
-		}
-	}
-
-	return false;
+	return nactive_others > 0;
 }
 
 static inline bool
@@ -930,10 +922,11 @@ tp_palm_detect_touch_size_triggered(struct tp_dispatch *tp,
 static inline bool
 tp_palm_detect_edge(struct tp_dispatch *tp,
 		    struct tp_touch *t,
+		    unsigned int nactive_others,
 		    uint64_t time)
 {
 	if (t->palm.state == PALM_EDGE) {
-		if (tp_palm_detect_multifinger(tp, t, time)) {
+		if (tp_palm_detect_multifinger(tp, t, nactive_others)) {
 			t->palm.state = PALM_NONE;
 			evdev_log_debug(tp->device,
 				  "palm: touch %d released, multiple fingers\n",
@@ -950,7 +943,7 @@ tp_palm_detect_edge(struct tp_dispatch *tp,
 				  t->index);
 		}
 		return false;
-	} else if (tp_palm_detect_multifinger(tp, t, time)) {
+	} else if (tp_palm_detect_multifinger(tp, t, nactive_others)) {
 		return false;
 	}
 
@@ -1007,8 +1000,15 @@ tp_palm_detect_arbitration_triggered(struct tp_dispatch *tp,
 	return true;
 }
 
+/**
+ * @param nactive_others The number of active touches other than t, see
+ * tp_touch_active()
+ */
 static void
-tp_palm_detect(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
+tp_palm_detect(struct tp_dispatch *tp,
+	       struct tp_touch *t,
+	       unsigned int nactive_others,
+	       uint64_t time)
 {
 	const char *palm_state;
 	enum touch_palm_state oldstate = t->palm.state;
@@ -1031,7 +1031,7 @@ tp_palm_detect(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 	if (tp_palm_detect_touch_size_triggered(tp, t, time))
 		goto out;
 
-	if (tp_palm_detect_edge(tp, t, time))
+	if (tp_palm_detect_edge(tp, t, nactive_others, time))
 		goto out;
 
 	/* Pressure is highest priority because it cannot be released and
@@ -1590,6 +1590,74 @@ tp_detect_thumb_by_position(struct tp_dispatch *tp, uint64_t time)
 
 }
 
+/* Timestamp in ns for the profiler, 0 if profiling is disabled at
+ * build time. The profiler is meant for finding the expensive phase on a
+ * specific device, see libinput measure touchpad-profile. */
+static inline uint64_t
+tp_profile_now(void)
+{
+#if HAVE_TOUCHPAD_PROFILING
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+	return 0;
+#endif
+}
+
+static inline void
+tp_profile_add(struct tp_dispatch *tp,
+	       enum tp_profile_phase phase,
+	       uint64_t start)
+{
+#if HAVE_TOUCHPAD_PROFILING
+	uint64_t elapsed = tp_profile_now() - start;
+
+	tp->profile.phase[phase].count++;
+	tp->profile.phase[phase].total += elapsed;
+	tp->profile.phase[phase].max = max(tp->profile.phase[phase].max,
+					   elapsed);
+#endif
+}
+
+static void
+tp_profile_dump(struct tp_dispatch *tp)
+{
+#if HAVE_TOUCHPAD_PROFILING
+	/* Sub-phases are prefixed with their parent phase, the measure
+	 * tool relies on that */
+	static const char *names[TP_PROFILE_PHASE_COUNT] = {
+		[TP_PROFILE_FRAME] = "frame",
+		[TP_PROFILE_PRE_PROCESS] = "frame/pre-process",
+		[TP_PROFILE_PROCESS] = "frame/process",
+		[TP_PROFILE_THUMB_PALM] = "frame/process/thumb-palm",
+		[TP_PROFILE_BUTTON_STATE] = "frame/process/buttons",
+		[TP_PROFILE_EDGE_SCROLL_STATE] = "frame/process/edge-scroll",
+		[TP_PROFILE_GESTURE_STATE] = "frame/process/gestures",
+		[TP_PROFILE_POST_EVENTS] = "frame/post-events",
+		[TP_PROFILE_TAP] = "frame/post-events/tap",
+		[TP_PROFILE_BUTTON_EVENTS] = "frame/post-events/buttons",
+		[TP_PROFILE_EDGE_SCROLL_EVENTS] = "frame/post-events/edge-scroll",
+		[TP_PROFILE_GESTURE_EVENTS] = "frame/post-events/gestures",
+		[TP_PROFILE_POST_PROCESS] = "frame/post-process",
+	};
+
+	for (int i = 0; i < TP_PROFILE_PHASE_COUNT; i++) {
+		if (tp->profile.phase[i].count == 0)
+			continue;
+
+		evdev_log_info(tp->device,
+			       "touchpad-profile: %s count %" PRIu64 " total %" PRIu64 "ns max %" PRIu64 "ns\n",
+			       names[i],
+			       tp->profile.phase[i].count,
+			       tp->profile.phase[i].total,
+			       tp->profile.phase[i].max);
+	}
+#endif
+}
+
 static void
 tp_pre_process_state(struct tp_dispatch *tp, uint64_t time)
 {
@@ -1617,12 +1685,25 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 	bool restart_filter = false;
 	bool want_motion_reset;
 	bool have_new_touch = false;
+	unsigned int nactive = 0;
+	uint64_t start;
 
 	tp_position_fake_touches(tp);
 
 	want_motion_reset = tp_need_motion_history_reset(tp);
 
+	/* Palm detection needs to know whether there are other active
+	 * touches. Count them once per frame and update the count as each
+	 * touch changes state below, rather than looping over all touches
+	 * for every touch. */
+	tp_for_each_touch(tp, t) {
+		if (tp_touch_active(tp, t))
+			nactive++;
+	}
+
 	tp_for_each_touch(tp, t) {
+		bool was_active;
+
 		if (t->state == TOUCH_NONE)
 			continue;
 
@@ -1651,8 +1732,12 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 			tp_motion_history_reset(t);
 		}
 
+		was_active = tp_touch_active(tp, t);
+
+		start = tp_profile_now();
 		tp_thumb_detect(tp, t, time);
-		tp_palm_detect(tp, t, time);
+		tp_palm_detect(tp, t, nactive - was_active, time);
+		tp_profile_add(tp, TP_PROFILE_THUMB_PALM, start);
 		tp_detect_wobbling(tp, t, time);
 		tp_motion_hysteresis(tp, t);
 		tp_motion_history_push(t);
@@ -1678,6 +1763,8 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 
 		tp_unpin_finger(tp, t);
 
+		nactive = nactive - was_active + tp_touch_active(tp, t);
+
 		if (t->state == TOUCH_BEGIN) {
 			have_new_touch = true;
 			restart_filter = true;
@@ -1698,8 +1785,13 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 	if (restart_filter)
 		filter_restart(tp->device->pointer.filter, tp, time);
 
+	start = tp_profile_now();
 	tp_button_handle_state(tp, time);
+	tp_profile_add(tp, TP_PROFILE_BUTTON_STATE, start);
+
+	start = tp_profile_now();
 	tp_edge_scroll_handle_state(tp, time);
+	tp_profile_add(tp, TP_PROFILE_EDGE_SCROLL_STATE, start);
 
 	/*
 	 * We have a physical button down event on a clickpad. To avoid
@@ -1711,7 +1803,9 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 	    tp->buttons.is_clickpad)
 		tp_pin_fingers(tp);
 
+	start = tp_profile_now();
 	tp_gesture_handle_state(tp, time);
+	tp_profile_add(tp, TP_PROFILE_GESTURE_STATE, start);
 }
 
 static void
@@ -1748,15 +1842,24 @@ static void
 tp_post_events(struct tp_dispatch *tp, uint64_t time)
 {
 	int filter_motion = 0;
+	uint64_t start;
+	int rc;
 
 	/* Only post (top) button events while suspended */
 	if (tp->device->is_suspended) {
+		start = tp_profile_now();
 		tp_post_button_events(tp, time);
+		tp_profile_add(tp, TP_PROFILE_BUTTON_EVENTS, start);
 		return;
 	}
 
+	start = tp_profile_now();
 	filter_motion |= tp_tap_handle_state(tp, time);
+	tp_profile_add(tp, TP_PROFILE_TAP, start);
+
+	start = tp_profile_now();
 	filter_motion |= tp_post_button_events(tp, time);
+	tp_profile_add(tp, TP_PROFILE_BUTTON_EVENTS, start);
 
 	if (filter_motion ||
 	    tp->palm.trackpoint_active ||
@@ -1766,22 +1869,50 @@ tp_post_events(struct tp_dispatch *tp, uint64_t time)
 		return;
 	}
 
-	if (tp_edge_scroll_post_events(tp, time) != 0)
+	start = tp_profile_now();
+	rc = tp_edge_scroll_post_events(tp, time);
+	tp_profile_add(tp, TP_PROFILE_EDGE_SCROLL_EVENTS, start);
+	if (rc != 0)
 		return;
 
+	start = tp_profile_now();
 	tp_gesture_post_events(tp, time);
+	tp_profile_add(tp, TP_PROFILE_GESTURE_EVENTS, start);
 }
 
 static void
 tp_handle_state(struct tp_dispatch *tp,
 		uint64_t time)
 {
+	uint64_t frame_start, start;
+
+	frame_start = tp_profile_now();
+
+	evdev_update_report_rate(tp->device, time);
+
+	/* Motion from the previous frame goes before anything from
+	 * this frame */
+	tp_gesture_flush_resample(tp, time);
+
+	start = tp_profile_now();
 	tp_pre_process_state(tp, time);
+	tp_profile_add(tp, TP_PROFILE_PRE_PROCESS, start);
+
+	start = tp_profile_now();
 	tp_process_state(tp, time);
+	tp_profile_add(tp, TP_PROFILE_PROCESS, start);
+
+	start = tp_profile_now();
 	tp_post_events(tp, time);
+	tp_profile_add(tp, TP_PROFILE_POST_EVENTS, start);
+
+	start = tp_profile_now();
 	tp_post_process_state(tp, time);
+	tp_profile_add(tp, TP_PROFILE_POST_PROCESS, start);
 
 	tp_clickpad_middlebutton_apply_config(tp->device);
+
+	tp_profile_add(tp, TP_PROFILE_FRAME, frame_start);
 }
 
 static inline void
@@ -1864,6 +1995,8 @@ tp_interface_remove(struct evdev_dispatch *dispatch)
 {
 	struct tp_dispatch *tp = tp_dispatch(dispatch);
 
+	tp_profile_dump(tp);
+
 	libinput_timer_cancel(&tp->arbitration.arbitration_timer);
 
 	tp_remove_tap(tp);
@@ -1883,6 +2016,7 @@ tp_interface_destroy(struct evdev_dispatch *dispatch)
 	libinput_timer_destroy(&tp->dwt.keyboard_timer);
 	libinput_timer_destroy(&tp->tap.timer);
 	libinput_timer_destroy(&tp->gesture.finger_count_switch_timer);
+	libinput_timer_destroy(&tp->resample.timer);
 	free(tp->touches);
 	free(tp);
 }
@@ -1900,7 +2034,8 @@ tp_clear_state(struct tp_dispatch *tp)
 	struct tp_touch *t;
 
 	/* Unroll the touchpad state.
-	 * Release buttons first. If tp is a clickpad, the button event
+	 * Send any resampled motion still pending, then release
+	 * buttons. If tp is a clickpad, the button event
 	 * must come before the touch up. If it isn't, the order doesn't
 	 * matter anyway
 	 *
@@ -1910,6 +2045,7 @@ tp_clear_state(struct tp_dispatch *tp)
 	 * Then lift all touches so the touchpad is in a neutral state.
 	 *
 	 */
+	tp_gesture_flush_resample(tp, now);
 	tp_release_all_buttons(tp, now);
 	tp_release_all_taps(tp, now);
 
@@ -2067,8 +2203,9 @@ tp_trackpoint_event(uint64_t time, struct libinput_event *event, void *data)
 		tp->palm.trackpoint_active = true;
 	}
 
-	libinput_timer_set(&tp->palm.trackpoint_timer,
-			   time + DEFAULT_TRACKPOINT_ACTIVITY_TIMEOUT);
+	libinput_timer_set_flags(&tp->palm.trackpoint_timer,
+				 time + DEFAULT_TRACKPOINT_ACTIVITY_TIMEOUT,
+				 TIMER_FLAG_COARSE);
 }
 
 static void
@@ -2079,8 +2216,9 @@ tp_keyboard_timeout(uint64_t now, void *data)
 	if (tp->dwt.dwt_enabled &&
 	    long_any_bit_set(tp->dwt.key_mask,
 			     ARRAY_LENGTH(tp->dwt.key_mask))) {
-		libinput_timer_set(&tp->dwt.keyboard_timer,
-				   now + DEFAULT_KEYBOARD_ACTIVITY_TIMEOUT_2);
+		libinput_timer_set_flags(&tp->dwt.keyboard_timer,
+					 now + DEFAULT_KEYBOARD_ACTIVITY_TIMEOUT_2,
+					 TIMER_FLAG_COARSE);
 		tp->dwt.keyboard_last_press_time = now;
 		evdev_log_debug(tp->device, "palm: keyboard timeout refresh\n");
 		return;
@@ -2185,8 +2323,9 @@ tp_keyboard_event(uint64_t time, struct libinput_event *event, void *data)
 
 	tp->dwt.keyboard_last_press_time = time;
 	long_set_bit(tp->dwt.key_mask, key);
-	libinput_timer_set(&tp->dwt.keyboard_timer,
-			   time + timeout);
+	libinput_timer_set_flags(&tp->dwt.keyboard_timer,
+				 time + timeout,
+				 TIMER_FLAG_COARSE);
 }
 
 static bool
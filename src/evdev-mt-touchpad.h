@@ -26,6 +26,7 @@
 
 #include <stdbool.h>
 
+#include "adaptive-timeout.h"
 #include "evdev.h"
 #include "filter.h"
 #include "timer.h"
@@ -221,6 +222,9 @@ struct tp_touch {
 
 	struct {
 		struct device_coords initial;
+		/* direction since initial, only updated when the touch
+		 * changed, see tp_gesture_update_directions() */
+		uint32_t direction;
 	} gesture;
 
 	struct {
@@ -243,6 +247,26 @@ enum suspend_trigger {
 	SUSPEND_TABLET_MODE     = 0x8,
 };
 
+/* The phases of tp_handle_state() timed with -Dtouchpad-profiling=true,
+ * see tp_profile_add() */
+enum tp_profile_phase {
+	TP_PROFILE_FRAME,
+	TP_PROFILE_PRE_PROCESS,
+	TP_PROFILE_PROCESS,
+	TP_PROFILE_THUMB_PALM,
+	TP_PROFILE_BUTTON_STATE,
+	TP_PROFILE_EDGE_SCROLL_STATE,
+	TP_PROFILE_GESTURE_STATE,
+	TP_PROFILE_POST_EVENTS,
+	TP_PROFILE_TAP,
+	TP_PROFILE_BUTTON_EVENTS,
+	TP_PROFILE_EDGE_SCROLL_EVENTS,
+	TP_PROFILE_GESTURE_EVENTS,
+	TP_PROFILE_POST_PROCESS,
+
+	TP_PROFILE_PHASE_COUNT,
+};
+
 struct tp_dispatch {
 	struct evdev_dispatch base;
 	struct evdev_device *device;
@@ -315,8 +339,44 @@ struct tp_dispatch {
 		double prev_scale;
 		double angle;
 		struct device_float_coords center;
+
+		/* distance, angle and center of touches[0] and touches[1],
+		 * only updated when either touch changed, see
+		 * tp_gesture_update_geometry() */
+		struct {
+			double distance;
+			double angle;
+			struct device_float_coords center;
+		} geometry;
+		/* set while frames are skipped with a finger count
+		 * pending, the cached geometry and directions then miss
+		 * those frames' changes and are recomputed in full */
+		bool cache_stale;
 	} gesture;
 
+	/* Pointer motion resampling, see tp_gesture_post_pointer_motion() */
+	struct {
+		struct libinput_device_config_resample config;
+		unsigned int rate;		/* Hz, 0 if disabled */
+		struct libinput_timer timer;
+
+		/* The motion of the current frame not yet sent, one event
+		 * per remaining sample */
+		unsigned int pending;
+		struct normalized_coords delta;
+		struct device_float_coords unaccel;
+		uint64_t frame_time;
+		uint64_t next_time;
+
+		/* Latency added by resampling, for the current sequence */
+		struct {
+			unsigned int frames;
+			unsigned int events;
+			uint64_t total_delay;
+			uint64_t max_delay;
+		} stats;
+	} resample;
+
 	struct {
 		bool is_clickpad;		/* true for clickpads */
 		bool has_topbuttons;
@@ -379,6 +439,11 @@ struct tp_dispatch {
 		bool drag_lock_enabled;
 
 		unsigned int nfingers_down;	/* number of fingers down for tapping (excl. thumb/palm) */
+
+		/* timeout after a single tap before its button is
+		 * released, learned from release-to-touch gaps of
+		 * double-taps and drags */
+		struct adaptive_timeout adaptive;
 	} tap;
 
 	struct {
@@ -452,6 +517,16 @@ struct tp_dispatch {
 		struct libinput_event_listener listener;
 		struct evdev_device *tablet_mode_switch;
 	} tablet_mode_switch;
+
+#if HAVE_TOUCHPAD_PROFILING
+	struct {
+		struct {
+			uint64_t count;
+			uint64_t total;	/* in ns */
+			uint64_t max;	/* in ns */
+		} phase[TP_PROFILE_PHASE_COUNT];
+	} profile;
+#endif
 };
 
 static inline struct tp_dispatch*
@@ -614,6 +689,9 @@ tp_init_gesture(struct tp_dispatch *tp);
 void
 tp_remove_gesture(struct tp_dispatch *tp);
 
+void
+tp_gesture_flush_resample(struct tp_dispatch *tp, uint64_t time);
+
 void
 tp_gesture_stop(struct tp_dispatch *tp, uint64_t time);
 
@@ -29,6 +29,10 @@
 
 #include "evdev-tablet-pad.h"
 
+/* How long after a mode toggle we re-read the LEDs from sysfs to
+ * verify the predicted mode */
+#define PAD_MODE_SYNC_TIMEOUT ms2us(100)
+
 #if HAVE_LIBWACOM
 #include <libwacom/libwacom.h>
 #endif
@@ -37,6 +41,11 @@ struct pad_led_group {
 	struct libinput_tablet_pad_mode_group base;
 	struct list led_list;
 	struct list toggle_button_list;
+	unsigned int ntoggle_buttons;
+
+	/* re-reads the LED state after a toggle, outside of the event
+	 * processing path */
+	struct libinput_timer sync_timer;
 };
 
 struct pad_mode_toggle_button {
@@ -100,6 +109,25 @@ pad_led_group_get_mode(struct pad_led_group *group)
 	return -EINVAL;
 }
 
+static void
+pad_led_group_sync_timeout(uint64_t now, void *data)
+{
+	struct pad_led_group *group = data;
+	struct evdev_device *device = evdev_device(group->base.device);
+	int rc;
+
+	rc = pad_led_group_get_mode(group);
+	if (rc < 0 || (unsigned int)rc == group->base.current_mode)
+		return;
+
+	evdev_log_debug(device,
+			"pad: mode group %u is in mode %d, expected %u\n",
+			group->base.index,
+			rc,
+			group->base.current_mode);
+	group->base.current_mode = rc;
+}
+
 static inline void
 pad_led_destroy(struct libinput *libinput,
 		struct pad_mode_led *led)
@@ -161,6 +189,7 @@ pad_led_group_destroy(struct libinput_tablet_pad_mode_group *g)
 	list_for_each_safe(led, tmpled, &group->led_list, link)
 		pad_led_destroy(g->device->seat->libinput, led);
 
+	libinput_timer_destroy(&group->sync_timer);
 	free(group);
 }
 
@@ -170,6 +199,7 @@ pad_group_new_basic(struct pad_dispatch *pad,
 		    int nleds)
 {
 	struct pad_led_group *group;
+	char timer_name[64];
 
 	group = zalloc(sizeof *group);
 	group->base.device = &pad->device->base;
@@ -181,6 +211,17 @@ pad_group_new_basic(struct pad_dispatch *pad,
 	list_init(&group->toggle_button_list);
 	list_init(&group->led_list);
 
+	snprintf(timer_name,
+		 sizeof(timer_name),
+		 "%s pad-mode-%u",
+		 evdev_device_get_sysname(pad->device),
+		 group_index);
+	libinput_timer_init(&group->sync_timer,
+			    pad_libinput_context(pad),
+			    timer_name,
+			    pad_led_group_sync_timeout,
+			    group);
+
 	return group;
 }
 
@@ -424,6 +465,7 @@ pad_init_mode_buttons(struct pad_dispatch *pad,
 				return 1;
 			g = (struct pad_led_group*)group;
 			list_insert(&g->toggle_button_list, &b->link);
+			g->ntoggle_buttons++;
 			group->toggle_button_mask |= 1 << i;
 		}
 	}
@@ -577,11 +619,25 @@ pad_init_leds(struct pad_dispatch *pad,
 	return rc;
 }
 
+void
+pad_cancel_leds(struct pad_dispatch *pad)
+{
+	struct libinput_tablet_pad_mode_group *g;
+
+	list_for_each(g, &pad->modes.mode_group_list, link) {
+		struct pad_led_group *group = (struct pad_led_group*)g;
+
+		libinput_timer_cancel(&group->sync_timer);
+	}
+}
+
 void
 pad_destroy_leds(struct pad_dispatch *pad)
 {
 	struct libinput_tablet_pad_mode_group *group, *tmpgrp;
 
+	pad_cancel_leds(pad);
+
 	list_for_each_safe(group, tmpgrp, &pad->modes.mode_group_list, link)
 		libinput_tablet_pad_mode_group_unref(group);
 }
@@ -589,7 +645,8 @@ pad_destroy_leds(struct pad_dispatch *pad)
 void
 pad_button_update_mode(struct libinput_tablet_pad_mode_group *g,
 		       unsigned int button_index,
-		       enum libinput_button_state state)
+		       enum libinput_button_state state,
+		       uint64_t time)
 {
 	struct pad_led_group *group = (struct pad_led_group*)g;
 	int rc;
@@ -600,6 +657,22 @@ pad_button_update_mode(struct libinput_tablet_pad_mode_group *g,
 	if (!libinput_tablet_pad_mode_group_button_is_toggle(g, button_index))
 		return;
 
+	/* With a single toggle button the kernel cycles through the
+	 * modes, so we can predict the new mode without reading sysfs
+	 * here. The timer re-reads the LEDs later in case we got out of
+	 * sync, e.g. because a client wrote to the LEDs.
+	 *
+	 * With multiple toggle buttons we don't know which mode each
+	 * button selects, so we have to ask the kernel.
+	 */
+	if (group->ntoggle_buttons == 1 && g->num_modes > 0) {
+		g->current_mode = (g->current_mode + 1) % g->num_modes;
+		libinput_timer_set_flags(&group->sync_timer,
+					 time + PAD_MODE_SYNC_TIMEOUT,
+					 TIMER_FLAG_COARSE);
+		return;
+	}
+
 	rc = pad_led_group_get_mode(group);
 	if (rc >= 0)
 		group->base.current_mode = rc;
@@ -380,7 +380,7 @@ pad_notify_button_mask(struct pad_dispatch *pad,
 			map = pad->button_map[code - 1];
 			if (map != -1) {
 				group = pad_button_get_mode_group(pad, map);
-				pad_button_update_mode(group, map, state);
+				pad_button_update_mode(group, map, state, time);
 				tablet_pad_notify_button(base, time, map, state, group);
 			}
 		}
@@ -498,6 +498,14 @@ pad_suspend(struct evdev_dispatch *dispatch,
 	pad_flush(pad, device, libinput_now(libinput));
 }
 
+static void
+pad_remove(struct evdev_dispatch *dispatch)
+{
+	struct pad_dispatch *pad = pad_dispatch(dispatch);
+
+	pad_cancel_leds(pad);
+}
+
 static void
 pad_destroy(struct evdev_dispatch *dispatch)
 {
@@ -510,7 +518,7 @@ pad_destroy(struct evdev_dispatch *dispatch)
 static struct evdev_dispatch_interface pad_interface = {
 	.process = pad_process,
 	.suspend = pad_suspend,
-	.remove = NULL,
+	.remove = pad_remove,
 	.destroy = pad_destroy,
 	.device_added = NULL,
 	.device_removed = NULL,
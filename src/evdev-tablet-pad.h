@@ -89,7 +89,10 @@ pad_init_leds(struct pad_dispatch *pad, struct evdev_device *device);
 void
 pad_destroy_leds(struct pad_dispatch *pad);
 void
+pad_cancel_leds(struct pad_dispatch *pad);
+void
 pad_button_update_mode(struct libinput_tablet_pad_mode_group *g,
 		       unsigned int pressed_button,
-		       enum libinput_button_state state);
+		       enum libinput_button_state state,
+		       uint64_t time);
 #endif
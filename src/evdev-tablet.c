@@ -96,33 +96,32 @@ tablet_history_reset(struct tablet_dispatch *tablet)
 static inline void
 tablet_history_push(struct tablet_dispatch *tablet,
 		    const struct tablet_axes *axes)
-{
-	unsigned int index = (tablet->history.index + 1) %
-				tablet_history_size(tablet);
-
-	tablet->history.samples[index] = *axes;
-	tablet->history.index = index;
-	tablet->history.count = min(tablet->history.count + 1,
-				    tablet_history_size(tablet));
-
-	if (tablet->history.count < tablet_history_size(tablet))
-		tablet_history_push(tablet, axes);
-}
-
-/**
- * Return a previous axis state, where index of 0 means "most recent", 1 is
- * "one before most recent", etc.
- */
-static inline const struct tablet_axes*
-tablet_history_get(const struct tablet_dispatch *tablet, unsigned int index)
 {
 	size_t sz = tablet_history_size(tablet);
+	unsigned int index = (tablet->history.index + 1) % sz;
+	struct tablet_axes *old = &tablet->history.samples[index];
+
+	/* Fill the whole history with the first sample, the average
+	 * then starts at that sample */
+	if (tablet->history.count == 0) {
+		for (index = 0; index < sz; index++)
+			tablet->history.samples[index] = *axes;
+		tablet->history.index = 0;
+		tablet->history.count = sz;
+		tablet->history.point_sum.x = axes->point.x * (int)sz;
+		tablet->history.point_sum.y = axes->point.y * (int)sz;
+		tablet->history.tilt_sum.x = axes->tilt.x * sz;
+		tablet->history.tilt_sum.y = axes->tilt.y * sz;
+		return;
+	}
 
-	assert(index < sz);
-	assert(index < tablet->history.count);
+	tablet->history.point_sum.x += axes->point.x - old->point.x;
+	tablet->history.point_sum.y += axes->point.y - old->point.y;
+	tablet->history.tilt_sum.x += axes->tilt.x - old->tilt.x;
+	tablet->history.tilt_sum.y += axes->tilt.y - old->tilt.y;
 
-	index = (tablet->history.index + sz - index) % sz;
-	return &tablet->history.samples[index];
+	*old = *axes;
+	tablet->history.index = index;
 }
 
 static inline void
@@ -131,6 +130,17 @@ tablet_reset_changed_axes(struct tablet_dispatch *tablet)
 	memset(tablet->changed_axes, 0, sizeof(tablet->changed_axes));
 }
 
+static inline bool
+tablet_has_changed_axes(const struct tablet_dispatch *tablet)
+{
+	for (size_t i = 0; i < sizeof(tablet->changed_axes); i++) {
+		if (tablet->changed_axes[i])
+			return true;
+	}
+
+	return false;
+}
+
 static bool
 tablet_device_has_axis(struct tablet_dispatch *tablet,
 		       enum libinput_tablet_tool_axis axis)
@@ -287,49 +297,41 @@ tablet_update_tool(struct tablet_dispatch *tablet,
 }
 
 static inline double
-normalize_slider(const struct input_absinfo *absinfo)
+normalize_slider(const struct tablet_axis_norm *norm)
 {
-	double range = absinfo->maximum - absinfo->minimum;
-	double value = (absinfo->value - absinfo->minimum) / range;
+	double value = (norm->absinfo->value - norm->minimum) / norm->range;
 
 	return value * 2 - 1;
 }
 
 static inline double
-normalize_distance(const struct input_absinfo *absinfo)
+normalize_distance(const struct tablet_axis_norm *norm)
 {
-	double range = absinfo->maximum - absinfo->minimum;
-	double value = (absinfo->value - absinfo->minimum) / range;
+	double value = (norm->absinfo->value - norm->minimum) / norm->range;
 
 	return value;
 }
 
 static inline double
-normalize_pressure(const struct input_absinfo *absinfo,
+normalize_pressure(const struct tablet_axis_norm *norm,
 		   struct libinput_tablet_tool *tool)
 {
-	double range = absinfo->maximum - absinfo->minimum;
 	int offset = tool->has_pressure_offset ?
 			tool->pressure_offset : 0;
-	double value = (absinfo->value - offset - absinfo->minimum) / range;
+	double value = (norm->absinfo->value - offset - norm->minimum) /
+			norm->range;
 
 	return value;
 }
 
 static inline double
-adjust_tilt(const struct input_absinfo *absinfo)
+adjust_tilt(const struct tablet_axis_norm *norm)
 {
-	double range = absinfo->maximum - absinfo->minimum;
-	double value = (absinfo->value - absinfo->minimum) / range;
+	double value;
 	const int WACOM_MAX_DEGREES = 64;
 
-	/* If resolution is nonzero, it's in units/radian. But require
-	 * a min/max less/greater than zero so we can assume 0 is the
-	 * center */
-	if (absinfo->resolution != 0 &&
-	    absinfo->maximum > 0 &&
-	    absinfo->minimum < 0) {
-		value = 180.0/M_PI * absinfo->value/absinfo->resolution;
+	if (norm->resolution != 0.0) {
+		value = 180.0/M_PI * norm->absinfo->value/norm->resolution;
 	} else {
 		/* Wacom supports physical [-64, 64] degrees, so map to that by
 		 * default. If other tablets have a different physical range or
@@ -337,6 +339,7 @@ adjust_tilt(const struct input_absinfo *absinfo)
 		 * here.
 		 */
 		/* Map to the (-1, 1) range */
+		value = (norm->absinfo->value - norm->minimum) / norm->range;
 		value = (value * 2) - 1;
 		value *= WACOM_MAX_DEGREES;
 	}
@@ -375,11 +378,10 @@ convert_tilt_to_rotation(struct tablet_dispatch *tablet)
 }
 
 static double
-convert_to_degrees(const struct input_absinfo *absinfo, double offset)
+convert_to_degrees(const struct tablet_axis_norm *norm, double offset)
 {
-	/* range is [0, 360[, i.e. range + 1 */
-	double range = absinfo->maximum - absinfo->minimum + 1;
-	double value = (absinfo->value - absinfo->minimum) / range;
+	/* range is [0, 360[, see tablet_init_axis_norm() */
+	double value = (norm->absinfo->value - norm->minimum) / norm->range;
 
 	return fmod(value * 360.0 + offset, 360.0);
 }
@@ -402,7 +404,7 @@ tablet_update_xy(struct tablet_dispatch *tablet,
 
 	if (bit_is_set(tablet->changed_axes, LIBINPUT_TABLET_TOOL_AXIS_X) ||
 	    bit_is_set(tablet->changed_axes, LIBINPUT_TABLET_TOOL_AXIS_Y)) {
-		absinfo = libevdev_get_abs_info(device->evdev, ABS_X);
+		absinfo = tablet->norm.x.absinfo;
 
 		if (device->left_handed.enabled)
 			value = invert_axis(absinfo);
@@ -411,7 +413,7 @@ tablet_update_xy(struct tablet_dispatch *tablet,
 
 		tablet->axes.point.x = value;
 
-		absinfo = libevdev_get_abs_info(device->evdev, ABS_Y);
+		absinfo = tablet->norm.y.absinfo;
 
 		if (device->left_handed.enabled)
 			value = invert_axis(absinfo);
@@ -462,59 +464,42 @@ tablet_update_pressure(struct tablet_dispatch *tablet,
 		       struct evdev_device *device,
 		       struct libinput_tablet_tool *tool)
 {
-	const struct input_absinfo *absinfo;
-
 	if (bit_is_set(tablet->changed_axes,
-		       LIBINPUT_TABLET_TOOL_AXIS_PRESSURE)) {
-		absinfo = libevdev_get_abs_info(device->evdev, ABS_PRESSURE);
-		tablet->axes.pressure = normalize_pressure(absinfo, tool);
-	}
+		       LIBINPUT_TABLET_TOOL_AXIS_PRESSURE))
+		tablet->axes.pressure = normalize_pressure(&tablet->norm.pressure,
+							   tool);
 }
 
 static inline void
 tablet_update_distance(struct tablet_dispatch *tablet,
 		       struct evdev_device *device)
 {
-	const struct input_absinfo *absinfo;
-
 	if (bit_is_set(tablet->changed_axes,
-		       LIBINPUT_TABLET_TOOL_AXIS_DISTANCE)) {
-		absinfo = libevdev_get_abs_info(device->evdev, ABS_DISTANCE);
-		tablet->axes.distance = normalize_distance(absinfo);
-	}
+		       LIBINPUT_TABLET_TOOL_AXIS_DISTANCE))
+		tablet->axes.distance = normalize_distance(&tablet->norm.distance);
 }
 
 static inline void
 tablet_update_slider(struct tablet_dispatch *tablet,
 		     struct evdev_device *device)
 {
-	const struct input_absinfo *absinfo;
-
 	if (bit_is_set(tablet->changed_axes,
-		       LIBINPUT_TABLET_TOOL_AXIS_SLIDER)) {
-		absinfo = libevdev_get_abs_info(device->evdev, ABS_WHEEL);
-		tablet->axes.slider = normalize_slider(absinfo);
-	}
+		       LIBINPUT_TABLET_TOOL_AXIS_SLIDER))
+		tablet->axes.slider = normalize_slider(&tablet->norm.slider);
 }
 
 static inline void
 tablet_update_tilt(struct tablet_dispatch *tablet,
 		   struct evdev_device *device)
 {
-	const struct input_absinfo *absinfo;
-
 	/* mouse rotation resets tilt to 0 so always fetch both axes if
 	 * either has changed */
 	if (bit_is_set(tablet->changed_axes,
 		       LIBINPUT_TABLET_TOOL_AXIS_TILT_X) ||
 	    bit_is_set(tablet->changed_axes,
 		       LIBINPUT_TABLET_TOOL_AXIS_TILT_Y)) {
-
-		absinfo = libevdev_get_abs_info(device->evdev, ABS_TILT_X);
-		tablet->axes.tilt.x = adjust_tilt(absinfo);
-
-		absinfo = libevdev_get_abs_info(device->evdev, ABS_TILT_Y);
-		tablet->axes.tilt.y = adjust_tilt(absinfo);
+		tablet->axes.tilt.x = adjust_tilt(&tablet->norm.tilt_x);
+		tablet->axes.tilt.y = adjust_tilt(&tablet->norm.tilt_y);
 
 		if (device->left_handed.enabled) {
 			tablet->axes.tilt.x *= -1;
@@ -527,15 +512,11 @@ static inline void
 tablet_update_artpen_rotation(struct tablet_dispatch *tablet,
 			      struct evdev_device *device)
 {
-	const struct input_absinfo *absinfo;
-
+	/* artpen has 0 with buttons pointing east */
 	if (bit_is_set(tablet->changed_axes,
-		       LIBINPUT_TABLET_TOOL_AXIS_ROTATION_Z)) {
-		absinfo = libevdev_get_abs_info(device->evdev,
-						ABS_Z);
-		/* artpen has 0 with buttons pointing east */
-		tablet->axes.rotation = convert_to_degrees(absinfo, 90);
-	}
+		       LIBINPUT_TABLET_TOOL_AXIS_ROTATION_Z))
+		tablet->axes.rotation = convert_to_degrees(&tablet->norm.rotation,
+							   90);
 }
 
 static inline void
@@ -594,29 +575,220 @@ tablet_update_wheel(struct tablet_dispatch *tablet,
 	}
 }
 
+#define TABLET_LOWPASS_MIN_CUTOFF 2.0 /* Hz */
+#define TABLET_LOWPASS_BETA 0.5 /* Hz per mm/s or per degree/s */
+#define TABLET_LOWPASS_VELOCITY_CUTOFF 1.0 /* Hz */
+
+static inline double
+tablet_lowpass_alpha(double cutoff, double dt)
+{
+	double tau = 1.0/(2 * M_PI * cutoff);
+
+	return 1.0/(1.0 + tau/dt);
+}
+
+/**
+ * One step of a 1-euro filter: the cutoff frequency rises with the
+ * filtered velocity, so a slow pen is smoothed heavily and a fast pen
+ * has little lag.
+ */
+static inline double
+tablet_lowpass_filter(struct tablet_lowpass *f, double value, double dt)
+{
+	double velocity = (value - f->value)/dt;
+	double cutoff;
+
+	f->velocity += tablet_lowpass_alpha(TABLET_LOWPASS_VELOCITY_CUTOFF, dt) *
+		       (velocity - f->velocity);
+	cutoff = TABLET_LOWPASS_MIN_CUTOFF +
+		 TABLET_LOWPASS_BETA * fabs(f->velocity);
+	f->value += tablet_lowpass_alpha(cutoff, dt) * (value - f->value);
+
+	return f->value;
+}
+
+static inline void
+tablet_lowpass_init(struct tablet_lowpass *f, double value)
+{
+	f->value = value;
+	f->velocity = 0.0;
+}
+
 static void
-tablet_smoothen_axes(const struct tablet_dispatch *tablet,
-		     struct tablet_axes *axes)
+tablet_lowpass_axes(struct tablet_dispatch *tablet,
+		    struct tablet_axes *axes,
+		    uint64_t time)
 {
-	size_t i;
-	size_t count = tablet_history_size(tablet);
-	struct tablet_axes smooth = { 0 };
+	const struct input_absinfo *absx = tablet->device->abs.absinfo_x,
+				   *absy = tablet->device->abs.absinfo_y;
+	double x = 1.0 * axes->point.x/absx->resolution,
+	       y = 1.0 * axes->point.y/absy->resolution;
+	double dt;
+
+	if (!tablet->smoothing.lowpass_valid) {
+		tablet_lowpass_init(&tablet->smoothing.x, x);
+		tablet_lowpass_init(&tablet->smoothing.y, y);
+		tablet_lowpass_init(&tablet->smoothing.tilt_x, axes->tilt.x);
+		tablet_lowpass_init(&tablet->smoothing.tilt_y, axes->tilt.y);
+		tablet->smoothing.lowpass_time = time;
+		tablet->smoothing.lowpass_valid = true;
+		return;
+	}
 
-	for (i = 0; i < count; i++) {
-		const struct tablet_axes *a = tablet_history_get(tablet, i);
+	/* Same-timestamp events happen on some devices, treat them as
+	 * the minimum sensible interval */
+	dt = max(time - tablet->smoothing.lowpass_time, ms2us(1)) / 1e6;
+	tablet->smoothing.lowpass_time = time;
+
+	x = tablet_lowpass_filter(&tablet->smoothing.x, x, dt);
+	y = tablet_lowpass_filter(&tablet->smoothing.y, y, dt);
+	axes->point.x = round(x * absx->resolution);
+	axes->point.y = round(y * absy->resolution);
+
+	axes->tilt.x = tablet_lowpass_filter(&tablet->smoothing.tilt_x,
+					     axes->tilt.x,
+					     dt);
+	axes->tilt.y = tablet_lowpass_filter(&tablet->smoothing.tilt_y,
+					     axes->tilt.y,
+					     dt);
+}
+
+static inline const char *
+tablet_smoothing_to_str(enum libinput_config_tablet_tool_smoothing method)
+{
+	switch (method) {
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_NONE:
+		return "none";
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE:
+		return "average";
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE:
+		return "adaptive";
+	}
+
+	return NULL;
+}
+
+static void
+tablet_smoothing_end_stroke(struct tablet_dispatch *tablet)
+{
+	struct evdev_device *device = tablet->device;
+	unsigned int count = tablet->smoothing.stroke.count;
+	double duration, lag, speed;
+
+	if (count == 0)
+		return;
+
+	duration = (tablet->smoothing.stroke.last_time -
+		    tablet->smoothing.stroke.first_time) / 1e6;
+	lag = tablet->smoothing.stroke.lag/count;
+	speed = duration > 0.0 ? tablet->smoothing.stroke.path/duration : 0.0;
+
+	/* At a constant speed, the distance the smooth position trails
+	 * the raw position is the speed times the latency added */
+	evdev_log_debug(device,
+			"tablet: stroke smoothing %s: %u samples, lag %.2fmm (%.1fms), jitter %.3fmm (raw %.3fmm)\n",
+			tablet_smoothing_to_str(tablet->smoothing.method),
+			count,
+			lag,
+			speed > 0.0 ? lag/speed * 1000 : 0.0,
+			count > 2 ? tablet->smoothing.stroke.jitter/(count - 2) : 0.0,
+			count > 2 ? tablet->smoothing.stroke.jitter_raw/(count - 2) : 0.0);
+
+	memset(&tablet->smoothing.stroke, 0, sizeof(tablet->smoothing.stroke));
+}
+
+static inline double
+second_difference(struct device_float_coords p,
+		  const struct device_float_coords prev[2])
+{
+	return hypot(p.x - 2 * prev[0].x + prev[1].x,
+		     p.y - 2 * prev[0].y + prev[1].y);
+}
+
+static void
+tablet_smoothing_update_stroke(struct tablet_dispatch *tablet,
+			       const struct tablet_axes *raw_axes,
+			       const struct tablet_axes *smooth_axes,
+			       uint64_t time)
+{
+	const struct input_absinfo *absx = tablet->device->abs.absinfo_x,
+				   *absy = tablet->device->abs.absinfo_y;
+	struct device_float_coords raw, smooth;
+	unsigned int count = tablet->smoothing.stroke.count;
+
+	if (!tablet_has_status(tablet, TABLET_TOOL_IN_CONTACT)) {
+		tablet_smoothing_end_stroke(tablet);
+		return;
+	}
+
+	raw.x = 1.0 * raw_axes->point.x/absx->resolution;
+	raw.y = 1.0 * raw_axes->point.y/absy->resolution;
+	smooth.x = 1.0 * smooth_axes->point.x/absx->resolution;
+	smooth.y = 1.0 * smooth_axes->point.y/absy->resolution;
+
+	if (count == 0)
+		tablet->smoothing.stroke.first_time = time;
+	else
+		tablet->smoothing.stroke.path +=
+			hypot(raw.x - tablet->smoothing.stroke.raw[0].x,
+			      raw.y - tablet->smoothing.stroke.raw[0].y);
+
+	if (count >= 2) {
+		tablet->smoothing.stroke.jitter_raw +=
+			second_difference(raw, tablet->smoothing.stroke.raw);
+		tablet->smoothing.stroke.jitter +=
+			second_difference(smooth, tablet->smoothing.stroke.smooth);
+	}
+
+	tablet->smoothing.stroke.lag += hypot(raw.x - smooth.x,
+					      raw.y - smooth.y);
+	tablet->smoothing.stroke.raw[1] = tablet->smoothing.stroke.raw[0];
+	tablet->smoothing.stroke.raw[0] = raw;
+	tablet->smoothing.stroke.smooth[1] = tablet->smoothing.stroke.smooth[0];
+	tablet->smoothing.stroke.smooth[0] = smooth;
+	tablet->smoothing.stroke.last_time = time;
+	tablet->smoothing.stroke.count++;
+}
+
+static inline void
+tablet_smoothing_reset(struct tablet_dispatch *tablet)
+{
+	tablet_smoothing_end_stroke(tablet);
+	tablet_history_reset(tablet);
+	tablet->smoothing.lowpass_valid = false;
+}
 
-		smooth.point.x += a->point.x;
-		smooth.point.y += a->point.y;
+static void
+tablet_smoothen_axes(struct tablet_dispatch *tablet,
+		     const struct libinput_tablet_tool *tool,
+		     struct tablet_axes *axes,
+		     uint64_t time)
+{
+	const struct tablet_axes raw = *axes;
+	int count = tablet_history_size(tablet);
 
-		smooth.tilt.x += a->tilt.x;
-		smooth.tilt.y += a->tilt.y;
+	if (tablet->smoothing.method != tool->smoothing) {
+		tablet_smoothing_reset(tablet);
+		tablet->smoothing.method = tool->smoothing;
 	}
 
-	axes->point.x = smooth.point.x/count;
-	axes->point.y = smooth.point.y/count;
+	switch (tablet->smoothing.method) {
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_NONE:
+		break;
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE:
+		tablet_history_push(tablet, &raw);
+		axes->point.x = tablet->history.point_sum.x/count;
+		axes->point.y = tablet->history.point_sum.y/count;
+		axes->tilt.x = tablet->history.tilt_sum.x/count;
+		axes->tilt.y = tablet->history.tilt_sum.y/count;
+		break;
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE:
+		tablet_lowpass_axes(tablet, axes, time);
+		break;
+	}
 
-	axes->tilt.x = smooth.tilt.x/count;
-	axes->tilt.y = smooth.tilt.y/count;
+	if (evdev_log_is_logged(tablet->device, LIBINPUT_LOG_PRIORITY_DEBUG))
+		tablet_smoothing_update_stroke(tablet, &raw, axes, time);
 }
 
 static bool
@@ -627,10 +799,9 @@ tablet_check_notify_axes(struct tablet_dispatch *tablet,
 			 uint64_t time)
 {
 	struct tablet_axes axes = {0};
-	const char tmp[sizeof(tablet->changed_axes)] = {0};
 	bool rc = false;
 
-	if (memcmp(tmp, tablet->changed_axes, sizeof(tmp)) == 0) {
+	if (!tablet_has_changed_axes(tablet)) {
 		axes = tablet->axes;
 		goto out;
 	}
@@ -657,8 +828,7 @@ tablet_check_notify_axes(struct tablet_dispatch *tablet,
 	rc = true;
 
 out:
-	tablet_history_push(tablet, &tablet->axes);
-	tablet_smoothen_axes(tablet, &axes);
+	tablet_smoothen_axes(tablet, tool, &axes, time);
 
 	/* The delta relies on the last *smooth* point, so we do it last */
 	axes.delta = tablet_tool_process_delta(tablet, tool, device, &axes, time);
@@ -1048,6 +1218,7 @@ tablet_get_tool(struct tablet_dispatch *tablet,
 
 		tool->pressure_offset = 0;
 		tool->has_pressure_offset = false;
+		tool->smoothing = LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE;
 		tool->pressure_threshold.lower = 0;
 		tool->pressure_threshold.upper = 1;
 
@@ -1131,8 +1302,8 @@ sanitize_pressure_distance(struct tablet_dispatch *tablet,
 	const struct input_absinfo *distance,
 	                           *pressure;
 
-	distance = libevdev_get_abs_info(tablet->device->evdev, ABS_DISTANCE);
-	pressure = libevdev_get_abs_info(tablet->device->evdev, ABS_PRESSURE);
+	distance = tablet->norm.distance.absinfo;
+	pressure = tablet->norm.pressure.absinfo;
 
 	if (!pressure || !distance)
 		return;
@@ -1201,8 +1372,8 @@ detect_pressure_offset(struct tablet_dispatch *tablet,
 			LIBINPUT_TABLET_TOOL_AXIS_PRESSURE))
 		return;
 
-	pressure = libevdev_get_abs_info(device->evdev, ABS_PRESSURE);
-	distance = libevdev_get_abs_info(device->evdev, ABS_DISTANCE);
+	pressure = tablet->norm.pressure.absinfo;
+	distance = tablet->norm.distance.absinfo;
 
 	if (!pressure || !distance)
 		return;
@@ -1268,7 +1439,7 @@ detect_tool_contact(struct tablet_dispatch *tablet,
 		evdev_log_bug_libinput(device,
 				       "Invalid status: leaving contact\n");
 
-	p = libevdev_get_abs_info(tablet->device->evdev, ABS_PRESSURE);
+	p = tablet->norm.pressure.absinfo;
 	if (!p) {
 		evdev_log_bug_libinput(device,
 				       "Missing pressure axis\n");
@@ -1310,7 +1481,7 @@ tablet_update_proximity_state(struct tablet_dispatch *tablet,
 	int dist_max = tablet->cursor_proximity_threshold;
 	int dist;
 
-	distance = libevdev_get_abs_info(tablet->device->evdev, ABS_DISTANCE);
+	distance = tablet->norm.distance.absinfo;
 	if (!distance)
 		return;
 
@@ -1548,7 +1719,7 @@ tablet_send_events(struct tablet_dispatch *tablet,
 
 	if (tablet_send_proximity_out(tablet, tool, device, &axes, time)) {
 		tablet_change_to_left_handed(device);
-		tablet_history_reset(tablet);
+		tablet_smoothing_reset(tablet);
 	}
 }
 
@@ -1650,8 +1821,9 @@ static inline void
 tablet_proximity_out_quirk_set_timer(struct tablet_dispatch *tablet,
 				     uint64_t time)
 {
-	libinput_timer_set(&tablet->quirks.prox_out_timer,
-			   time + FORCED_PROXOUT_TIMEOUT);
+	libinput_timer_set_flags(&tablet->quirks.prox_out_timer,
+				 time + FORCED_PROXOUT_TIMEOUT,
+				 TIMER_FLAG_COARSE);
 }
 
 static void
@@ -2038,6 +2210,58 @@ tablet_reject_device(struct evdev_device *device)
 	return -1;
 }
 
+static void
+tablet_init_axis_norm_one(struct tablet_axis_norm *norm,
+			  struct evdev_device *device,
+			  unsigned int code)
+{
+	const struct input_absinfo *absinfo;
+
+	absinfo = libevdev_get_abs_info(device->evdev, code);
+	if (!absinfo)
+		return;
+
+	norm->absinfo = absinfo;
+	norm->minimum = absinfo->minimum;
+	norm->range = absinfo->maximum - absinfo->minimum;
+}
+
+static void
+tablet_init_axis_norm(struct tablet_dispatch *tablet,
+		      struct evdev_device *device)
+{
+	struct tablet_axis_norm *tilt[] = {
+		&tablet->norm.tilt_x,
+		&tablet->norm.tilt_y,
+	};
+	struct tablet_axis_norm **t;
+
+	tablet_init_axis_norm_one(&tablet->norm.x, device, ABS_X);
+	tablet_init_axis_norm_one(&tablet->norm.y, device, ABS_Y);
+	tablet_init_axis_norm_one(&tablet->norm.pressure, device, ABS_PRESSURE);
+	tablet_init_axis_norm_one(&tablet->norm.distance, device, ABS_DISTANCE);
+	tablet_init_axis_norm_one(&tablet->norm.slider, device, ABS_WHEEL);
+	tablet_init_axis_norm_one(&tablet->norm.tilt_x, device, ABS_TILT_X);
+	tablet_init_axis_norm_one(&tablet->norm.tilt_y, device, ABS_TILT_Y);
+	tablet_init_axis_norm_one(&tablet->norm.rotation, device, ABS_Z);
+
+	/* rotation range is [0, 360[, i.e. range + 1 */
+	tablet->norm.rotation.range += 1;
+
+	/* If resolution is nonzero, it's in units/radian. But require
+	 * a min/max less/greater than zero so we can assume 0 is the
+	 * center */
+	ARRAY_FOR_EACH(tilt, t) {
+		const struct input_absinfo *absinfo = (*t)->absinfo;
+
+		if (absinfo &&
+		    absinfo->resolution != 0 &&
+		    absinfo->maximum > 0 &&
+		    absinfo->minimum < 0)
+			(*t)->resolution = absinfo->resolution;
+	}
+}
+
 static int
 tablet_init(struct tablet_dispatch *tablet,
 	    struct evdev_device *device)
@@ -2077,6 +2301,7 @@ tablet_init(struct tablet_dispatch *tablet,
 		return rc;
 
 	tablet_init_left_handed(device);
+	tablet_init_axis_norm(tablet, device);
 
 	for (axis = LIBINPUT_TABLET_TOOL_AXIS_X;
 	     axis <= LIBINPUT_TABLET_TOOL_AXIS_MAX;
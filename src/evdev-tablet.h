@@ -50,6 +50,22 @@ struct button_state {
 	unsigned char bits[NCHARS(KEY_CNT)];
 };
 
+/* State of one axis in the adaptive low-pass filter */
+struct tablet_lowpass {
+	double value;
+	double velocity;
+};
+
+/* Axis normalization data, computed once at init so we don't need to look
+ * up the absinfo for every event */
+struct tablet_axis_norm {
+	const struct input_absinfo *absinfo;
+	double minimum;
+	double range;
+	/* tilt only: units/radian, 0 if the axis has no usable resolution */
+	double resolution;
+};
+
 struct tablet_dispatch {
 	struct evdev_dispatch base;
 	struct evdev_device *device;
@@ -61,8 +77,44 @@ struct tablet_dispatch {
 		unsigned int index;
 		unsigned int count;
 		struct tablet_axes samples[TABLET_HISTORY_LENGTH];
+		/* sums of the samples above, updated on every push */
+		struct device_coords point_sum;
+		struct tilt_degrees tilt_sum;
 	} history;
 
+	struct {
+		/* the method the state below belongs to, switched to the
+		 * tool's method on the next sample */
+		enum libinput_config_tablet_tool_smoothing method;
+
+		/* adaptive low-pass, in mm and degrees */
+		bool lowpass_valid;
+		uint64_t lowpass_time;
+		struct tablet_lowpass x, y, tilt_x, tilt_y;
+
+		/* only collected with debug logging enabled */
+		struct {
+			unsigned int count;
+			uint64_t first_time;
+			uint64_t last_time;
+			double lag;		/* sum of raw-smooth distances */
+			double path;		/* raw path length */
+			double jitter_raw;	/* sums of the second */
+			double jitter;		/* differences, in mm */
+			struct device_float_coords raw[2];
+			struct device_float_coords smooth[2];
+		} stroke;
+	} smoothing;
+
+	struct {
+		struct tablet_axis_norm x, y;
+		struct tablet_axis_norm pressure;
+		struct tablet_axis_norm distance;
+		struct tablet_axis_norm slider;
+		struct tablet_axis_norm tilt_x, tilt_y;
+		struct tablet_axis_norm rotation;
+	} norm;
+
 	unsigned char axis_caps[NCHARS(LIBINPUT_TABLET_TOOL_AXIS_MAX + 1)];
 	int current_value[LIBINPUT_TABLET_TOOL_AXIS_MAX + 1];
 	int prev_value[LIBINPUT_TABLET_TOOL_AXIS_MAX + 1];
@@ -30,11 +30,11 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include "linux/input.h"
 #include <unistd.h>
 #include <fcntl.h>
-#include <mtdev-plumbing.h>
 #include <assert.h>
 #include <time.h>
 #include <math.h>
@@ -43,12 +43,17 @@
 #include "evdev.h"
 #include "filter.h"
 #include "libinput-private.h"
+#include "libinput-trace.h"
 #include "quirks.h"
 
 #if HAVE_LIBWACOM
 #include <libwacom/libwacom.h>
 #endif
 
+#if HAVE_MTDEV
+#include <mtdev-plumbing.h>
+#endif
+
 #define DEFAULT_WHEEL_CLICK_ANGLE 15
 #define DEFAULT_BUTTON_SCROLL_TIMEOUT ms2us(200)
 
@@ -346,6 +351,60 @@ evdev_device_transform_y(struct evdev_device *device,
 	return scale_axis(device->abs.absinfo_y, y, height);
 }
 
+/* Smoothing time constant for the scroll velocity */
+#define SCROLL_VELOCITY_TAU ms2us(50)
+/* If no scroll event arrived for this long, the fingers stopped */
+#define SCROLL_VELOCITY_TIMEOUT ms2us(100)
+
+static void
+evdev_scroll_update_velocity(struct evdev_device *device,
+			     uint64_t time,
+			     const struct normalized_coords *delta)
+{
+	struct normalized_coords *v = &device->scroll.velocity.velocity;
+	uint64_t last_time = device->scroll.velocity.last_time;
+	double dt, alpha;
+
+	device->scroll.velocity.last_time = time;
+
+	if (last_time == 0 ||
+	    time < last_time ||
+	    time - last_time > SCROLL_VELOCITY_TIMEOUT) {
+		v->x = 0.0;
+		v->y = 0.0;
+		return;
+	}
+
+	/* Same-timestamp events happen when both axes scroll in separate
+	 * events, treat them as the minimum sensible interval */
+	dt = max(time - last_time, ms2us(1));
+	alpha = dt/(SCROLL_VELOCITY_TAU + dt);
+
+	dt /= 1e6;
+	v->x += alpha * (delta->x/dt - v->x);
+	v->y += alpha * (delta->y/dt - v->y);
+}
+
+static struct normalized_coords
+evdev_scroll_end_velocity(struct evdev_device *device, uint64_t time)
+{
+	struct normalized_coords velocity = device->scroll.velocity.velocity;
+	uint64_t last_time = device->scroll.velocity.last_time;
+
+	if (last_time == 0 ||
+	    time < last_time ||
+	    time - last_time > SCROLL_VELOCITY_TIMEOUT) {
+		velocity.x = 0.0;
+		velocity.y = 0.0;
+	}
+
+	device->scroll.velocity.velocity.x = 0.0;
+	device->scroll.velocity.velocity.y = 0.0;
+	device->scroll.velocity.last_time = 0;
+
+	return velocity;
+}
+
 void
 evdev_notify_axis(struct evdev_device *device,
 		  uint64_t time,
@@ -356,6 +415,7 @@ evdev_notify_axis(struct evdev_device *device,
 {
 	struct normalized_coords delta = *delta_in;
 	struct discrete_coords discrete = *discrete_in;
+	struct normalized_coords velocity = { 0.0, 0.0 };
 
 	if (device->scroll.natural_scrolling_enabled) {
 		delta.x *= -1;
@@ -364,12 +424,22 @@ evdev_notify_axis(struct evdev_device *device,
 		discrete.y *= -1;
 	}
 
+	/* A zero delta terminates a finger/continuous scroll sequence */
+	if (source == LIBINPUT_POINTER_AXIS_SOURCE_FINGER ||
+	    source == LIBINPUT_POINTER_AXIS_SOURCE_CONTINUOUS) {
+		if (normalized_is_zero(delta))
+			velocity = evdev_scroll_end_velocity(device, time);
+		else
+			evdev_scroll_update_velocity(device, time, &delta);
+	}
+
 	pointer_notify_axis(&device->base,
 			    time,
 			    axes,
 			    source,
 			    &delta,
-			    &discrete);
+			    &discrete,
+			    &velocity);
 }
 
 static void
@@ -775,8 +845,8 @@ evdev_init_natural_scroll(struct evdev_device *device)
 	device->base.config.natural_scroll = &device->scroll.config_natural;
 }
 
-int
-evdev_need_mtdev(struct evdev_device *device)
+bool
+evdev_is_protocol_a_device(struct evdev_device *device)
 {
 	struct libevdev *evdev = device->evdev;
 
@@ -868,18 +938,26 @@ evdev_process_event(struct evdev_device *device, struct input_event *e)
 	evdev_print_event(device, e);
 #endif
 
+	libinput_trace5(evdev_event, device, e->type, e->code, e->value, time);
+
 	libinput_timer_flush(evdev_libinput_context(device), time);
 
+	libinput_begin_frame(evdev_libinput_context(device));
+
+	libinput_trace3(process_begin, device, dispatch->dispatch_type, time);
 	dispatch->interface->process(dispatch, device, e, time);
+	libinput_trace3(process_end, device, dispatch->dispatch_type, time);
+
+	if (e->type == EV_SYN && e->code == SYN_REPORT)
+		libinput_end_frame(evdev_libinput_context(device));
 }
 
 static inline void
 evdev_device_dispatch_one(struct evdev_device *device,
 			  struct input_event *ev)
 {
-	if (!device->mtdev) {
-		evdev_process_event(device, ev);
-	} else {
+#if HAVE_MTDEV
+	if (device->mtdev) {
 		mtdev_put_event(device->mtdev, ev);
 		if (libevdev_event_is_code(ev, EV_SYN, SYN_REPORT)) {
 			while (!mtdev_empty(device->mtdev)) {
@@ -888,7 +966,11 @@ evdev_device_dispatch_one(struct evdev_device *device,
 				evdev_process_event(device, &e);
 			}
 		}
+		return;
 	}
+#endif
+
+	evdev_process_event(device, ev);
 }
 
 static int
@@ -1067,6 +1149,11 @@ evdev_device_init_pointer_acceleration(struct evdev_device *device,
 {
 	device->pointer.filter = filter;
 
+	if (device->report_rate.rate) {
+		filter_set_report_rate(filter, device->report_rate.rate);
+		device->pointer.filter_rate = device->report_rate.rate;
+	}
+
 	if (device->base.config.accel == NULL) {
 		double default_speed;
 
@@ -1958,6 +2045,100 @@ evdev_pre_configure_model_quirks(struct evdev_device *device)
 	libevdev_disable_event_code(device->evdev, EV_MSC, MSC_TIMESTAMP);
 }
 
+static inline bool
+evdev_dispatch_consumes_code(struct evdev_device *device,
+			     unsigned int type,
+			     unsigned int code)
+{
+	/* Disabled codes are discarded by libevdev anyway */
+	if (!libevdev_has_event_code(device->evdev, type, code))
+		return false;
+
+	switch (device->dispatch->dispatch_type) {
+	case DISPATCH_TOUCHPAD:
+	case DISPATCH_TABLET_PAD:
+		return type == EV_KEY || type == EV_ABS;
+	case DISPATCH_TABLET:
+		if (type == EV_MSC)
+			return code == MSC_SERIAL;
+		return type == EV_KEY || type == EV_ABS || type == EV_REL;
+	case DISPATCH_FALLBACK:
+		return type != EV_MSC && type != EV_LED;
+	}
+
+	return true;
+}
+
+/**
+ * Program the kernel's per-client event mask so events we discard
+ * anyway are never read from the fd in the first place. The mask is
+ * per open file, so this must be called whenever the fd changes.
+ */
+static void
+evdev_device_set_event_mask(struct evdev_device *device)
+{
+#ifdef EVIOCSMASK
+	const unsigned int types[] = {
+		EV_KEY, EV_REL, EV_ABS, EV_MSC, EV_SW, EV_LED,
+	};
+	const unsigned int *type;
+
+	ARRAY_FOR_EACH(types, type) {
+		unsigned long bits[NLONGS(KEY_CNT)] = {0};
+		unsigned long mask[NLONGS(KEY_CNT)] = {0};
+		struct input_mask m;
+		char masked[1024] = {0};
+		size_t len = 0;
+		int max;
+		unsigned int code;
+
+		max = libevdev_event_type_get_max(*type);
+		if (max == -1)
+			continue;
+
+		if (ioctl(device->fd, EVIOCGBIT(*type, sizeof(bits)), bits) < 0)
+			continue;
+
+		for (code = 0; code <= (unsigned int)max; code++) {
+			const char *name;
+
+			if (!long_bit_is_set(bits, code))
+				continue;
+
+			if (evdev_dispatch_consumes_code(device, *type, code)) {
+				long_set_bit(mask, code);
+				continue;
+			}
+
+			name = libevdev_event_code_get_name(*type, code);
+			if (len < sizeof(masked))
+				len += snprintf(&masked[len],
+						sizeof(masked) - len,
+						" %s",
+						name ? name : "?");
+		}
+
+		if (masked[0] == '\0')
+			continue;
+
+		m.type = *type;
+		m.codes_size = sizeof(mask);
+		m.codes_ptr = (uint64_t)(uintptr_t)mask;
+		if (ioctl(device->fd, EVIOCSMASK, &m) < 0) {
+			evdev_log_debug(device,
+					"failed to set the kernel event mask (%s)\n",
+					strerror(errno));
+			return;
+		}
+
+		evdev_log_debug(device,
+				"kernel event mask %s:%s\n",
+				libevdev_event_type_get_name(*type),
+				masked);
+	}
+#endif
+}
+
 static void
 libevdev_log_func(const struct libevdev *evdev,
 		  enum libevdev_log_priority priority,
@@ -2090,6 +2271,8 @@ evdev_device_create(struct libinput_seat *seat,
 		goto err;
 	}
 
+	evdev_device_set_event_mask(device);
+
 	device->source =
 		libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
 	if (!device->source)
@@ -2349,10 +2532,10 @@ evdev_device_get_touch_count(struct evdev_device *device)
 
 	ntouches = libevdev_get_num_slots(device->evdev);
 	if (ntouches == -1) {
-		/* mtdev devices have multitouch but we don't know
+		/* Protocol A devices have multitouch but we don't know
 		 * how many. Otherwise, any touch device with num_slots of
 		 * -1 is a single-touch device */
-		if (device->mtdev)
+		if (evdev_is_protocol_a_device(device))
 			ntouches = 0;
 		else
 			ntouches = 1;
@@ -2361,6 +2544,35 @@ evdev_device_get_touch_count(struct evdev_device *device)
 	return ntouches;
 }
 
+int
+evdev_device_get_report_rate(struct evdev_device *device)
+{
+	if (!(device->seat_caps & EVDEV_DEVICE_POINTER))
+		return -1;
+
+	return device->report_rate.rate;
+}
+
+void
+evdev_update_report_rate(struct evdev_device *device, uint64_t time)
+{
+	unsigned int rate, filter_rate;
+
+	if (!report_rate_update(&device->report_rate, time))
+		return;
+
+	/* The filter only needs to know about significant changes */
+	rate = device->report_rate.rate;
+	filter_rate = device->pointer.filter_rate;
+	if (!device->pointer.filter ||
+	    (rate > filter_rate * 3/4 && rate < filter_rate * 5/4))
+		return;
+
+	evdev_log_debug(device, "report rate is %uHz\n", rate);
+	filter_set_report_rate(device->pointer.filter, rate);
+	device->pointer.filter_rate = rate;
+}
+
 int
 evdev_device_has_switch(struct evdev_device *device,
 			enum libinput_switch sw)
@@ -2486,6 +2698,9 @@ evdev_stop_scroll(struct evdev_device *device,
 {
 	const struct normalized_coords zero = { 0.0, 0.0 };
 	const struct discrete_coords zero_discrete = { 0.0, 0.0 };
+	struct normalized_coords velocity;
+
+	velocity = evdev_scroll_end_velocity(device, time);
 
 	/* terminate scrolling with a zero scroll event */
 	if (device->scroll.direction != 0)
@@ -2494,7 +2709,8 @@ evdev_stop_scroll(struct evdev_device *device,
 				    device->scroll.direction,
 				    source,
 				    &zero,
-				    &zero_discrete);
+				    &zero_discrete,
+				    &velocity);
 
 	device->scroll.buildup.x = 0;
 	device->scroll.buildup.y = 0;
@@ -2557,10 +2773,11 @@ evdev_device_suspend(struct evdev_device *device)
 		device->source = NULL;
 	}
 
-	if (device->mtdev) {
-		mtdev_close_delete(device->mtdev);
-		device->mtdev = NULL;
-	}
+#if HAVE_MTDEV
+	/* only closes the fd state, the struct is re-opened on resume */
+	if (device->mtdev)
+		mtdev_close(device->mtdev);
+#endif
 
 	if (device->fd != -1) {
 		close_restricted(libinput, device->fd);
@@ -2602,14 +2819,14 @@ evdev_device_resume(struct evdev_device *device)
 
 	device->fd = fd;
 
-	if (evdev_need_mtdev(device)) {
-		device->mtdev = mtdev_new_open(device->fd);
-		if (!device->mtdev)
-			return -ENODEV;
-	}
+#if HAVE_MTDEV
+	if (device->mtdev && mtdev_open(device->mtdev, fd) < 0)
+		return -ENODEV;
+#endif
 
 	libevdev_change_fd(device->evdev, fd);
 	libevdev_set_clock_id(device->evdev, CLOCK_MONOTONIC);
+	evdev_device_set_event_mask(device);
 
 	/* re-sync libevdev's view of the device, but discard the actual
 	   events. Our device is in a neutral state already */
@@ -2624,10 +2841,8 @@ evdev_device_resume(struct evdev_device *device)
 
 	device->source =
 		libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
-	if (!device->source) {
-		mtdev_close_delete(device->mtdev);
+	if (!device->source)
 		return -ENOMEM;
-	}
 
 	evdev_notify_resumed_device(device);
 
@@ -2682,6 +2897,9 @@ evdev_device_destroy(struct evdev_device *device)
 	libinput_timer_destroy(&device->scroll.timer);
 	libinput_timer_destroy(&device->middlebutton.timer);
 	libinput_seat_unref(device->base.seat);
+#if HAVE_MTDEV
+	mtdev_close_delete(device->mtdev);
+#endif
 	libevdev_free(device->evdev);
 	udev_device_unref(device->udev_device);
 	free(device);
@@ -33,7 +33,9 @@
 #include "linux/input.h"
 #include <libevdev/libevdev.h>
 
+#include "adaptive-timeout.h"
 #include "libinput-private.h"
+#include "report-rate.h"
 #include "timer.h"
 #include "filter.h"
 
@@ -165,7 +167,6 @@ enum mt_slot_state {
 };
 
 struct mt_slot {
-	bool dirty;
 	enum mt_slot_state state;
 	int32_t seat_slot;
 	struct device_coords point;
@@ -193,7 +194,7 @@ struct evdev_device {
 	struct ratelimit syn_drop_limit; /* ratelimit for SYN_DROPPED logging */
 	struct ratelimit nonpointer_rel_limit; /* ratelimit for REL_* events from non-pointer devices */
 	uint32_t model_flags;
-	struct mtdev *mtdev;
+	struct mtdev *mtdev; /* Protocol A conversion, NULL unless HAVE_MTDEV */
 
 	struct {
 		const struct input_absinfo *absinfo_x, *absinfo_y;
@@ -232,6 +233,13 @@ struct evdev_device {
 		uint32_t direction;
 		struct normalized_coords buildup;
 
+		/* smoothed velocity of the current scroll sequence, in
+		 * units per second, see evdev_scroll_update_velocity() */
+		struct {
+			struct normalized_coords velocity;
+			uint64_t last_time;
+		} velocity;
+
 		struct libinput_device_config_natural_scroll config_natural;
 		/* set during device init if we want natural scrolling,
 		 * used at runtime to enable/disable the feature */
@@ -246,8 +254,12 @@ struct evdev_device {
 	struct {
 		struct libinput_device_config_accel config;
 		struct motion_filter *filter;
+		/* Hz, the last report rate passed to the filter */
+		unsigned int filter_rate;
 	} pointer;
 
+	struct report_rate report_rate;
+
 	/* Key counter used for multiplexing button events internally in
 	 * libinput. */
 	uint8_t key_count[KEY_CNT];
@@ -273,6 +285,19 @@ struct evdev_device {
 		struct libinput_timer timer;
 		uint32_t button_mask;
 		uint64_t first_event_time;
+
+		/* timeout before a single left/right press is sent,
+		 * learned from first-to-second press gaps of middle
+		 * clicks */
+		struct adaptive_timeout adaptive;
+
+		struct {
+			/* number of left/right presses held back, their
+			 * total and their maximum delay */
+			unsigned int count;
+			uint64_t total;
+			uint64_t max;
+		} latency;
 	} middlebutton;
 };
 
@@ -416,8 +441,8 @@ fallback_dispatch_create(struct libinput_device *libinput_device);
 bool
 evdev_is_fake_mt_device(struct evdev_device *device);
 
-int
-evdev_need_mtdev(struct evdev_device *device);
+bool
+evdev_is_protocol_a_device(struct evdev_device *device);
 
 void
 evdev_device_led_update(struct evdev_device *device, enum libinput_led leds);
@@ -468,6 +493,12 @@ evdev_device_has_key(struct evdev_device *device, uint32_t code);
 int
 evdev_device_get_touch_count(struct evdev_device *device);
 
+int
+evdev_device_get_report_rate(struct evdev_device *device);
+
+void
+evdev_update_report_rate(struct evdev_device *device, uint64_t time);
+
 int
 evdev_device_has_switch(struct evdev_device *device,
 			enum libinput_switch sw);
@@ -712,6 +743,13 @@ evdev_libinput_context(const struct evdev_device *device)
 	return device->base.seat->libinput;
 }
 
+static inline bool
+evdev_log_is_logged(const struct evdev_device *device,
+		    enum libinput_log_priority priority)
+{
+	return log_is_logged(evdev_libinput_context(device), priority);
+}
+
 LIBINPUT_ATTRIBUTE_PRINTF(3, 0)
 static inline void
 evdev_log_msg_va(struct evdev_device *device,
@@ -721,6 +759,9 @@ evdev_log_msg_va(struct evdev_device *device,
 {
 	char buf[1024];
 
+	if (!evdev_log_is_logged(device, priority))
+		return;
+
 	/* Anything info and above is user-visible, use the device name */
 	snprintf(buf,
 		 sizeof(buf),
@@ -759,6 +800,9 @@ evdev_log_msg_ratelimit(struct evdev_device *device,
 	va_list args;
 	enum ratelimit_state state;
 
+	if (!evdev_log_is_logged(device, priority))
+		return;
+
 	state = ratelimit_test(ratelimit);
 	if (state == RATELIMIT_EXCEEDED)
 		return;
@@ -775,7 +819,13 @@ evdev_log_msg_ratelimit(struct evdev_device *device,
 			      us2ms(ratelimit->interval));
 }
 
-#define evdev_log_debug(d_, ...) evdev_log_msg((d_), LIBINPUT_LOG_PRIORITY_DEBUG, __VA_ARGS__)
+/* Debug messages are the only ones in hot paths, check the priority
+ * before evaluating the arguments */
+#define evdev_log_debug(d_, ...) \
+	do { \
+		if (evdev_log_is_logged((d_), LIBINPUT_LOG_PRIORITY_DEBUG)) \
+			evdev_log_msg((d_), LIBINPUT_LOG_PRIORITY_DEBUG, __VA_ARGS__); \
+	} while (0)
 #define evdev_log_info(d_, ...) evdev_log_msg((d_), LIBINPUT_LOG_PRIORITY_INFO, __VA_ARGS__)
 #define evdev_log_error(d_, ...) evdev_log_msg((d_), LIBINPUT_LOG_PRIORITY_ERROR, __VA_ARGS__)
 #define evdev_log_bug_kernel(d_, ...) evdev_log_msg((d_), LIBINPUT_LOG_PRIORITY_ERROR, "kernel bug: " __VA_ARGS__)
@@ -318,6 +318,7 @@ create_default_filter(int dpi)
 	filter->last_velocity = 0.0;
 
 	trackers_init(&filter->trackers);
+	filter->base.trackers = &filter->trackers;
 
 	filter->threshold = DEFAULT_THRESHOLD;
 	filter->accel = DEFAULT_ACCELERATION;
@@ -49,10 +49,11 @@ struct motion_filter_interface {
 struct motion_filter {
 	double speed_adjustment; /* normalized [-1, 1] */
 	struct motion_filter_interface *interface;
+	struct pointer_trackers *trackers; /* NULL if there is no history */
 };
 
 struct pointer_tracker {
-	struct device_float_coords delta; /* delta to most recent event */
+	struct device_float_coords pos; /* accumulated motion at this event */
 	uint64_t time;  /* us */
 	uint32_t dir;
 };
@@ -68,6 +69,11 @@ struct pointer_trackers {
 	size_t ntrackers;
 	unsigned int cur_tracker;
 
+	/* Sum of all deltas since the last reset. The delta between a
+	 * tracker and the most recent event is pos - tracker->pos, so
+	 * feeding a new event doesn't need to touch the other trackers */
+	struct device_float_coords pos;
+
 	struct pointer_delta_smoothener *smoothener;
 };
 
@@ -81,10 +87,25 @@ void
 trackers_feed(struct pointer_trackers *trackers,
 	      const struct device_float_coords *delta,
 	      uint64_t time);
+void
+trackers_set_report_rate(struct pointer_trackers *trackers,
+			 unsigned int rate);
 
 struct pointer_tracker *
 trackers_by_offset(struct pointer_trackers *trackers, unsigned int offset);
 
+static inline struct device_float_coords
+tracker_delta(const struct pointer_trackers *trackers,
+	      const struct pointer_tracker *tracker)
+{
+	struct device_float_coords delta;
+
+	delta.x = trackers->pos.x - tracker->pos.x;
+	delta.y = trackers->pos.y - tracker->pos.y;
+
+	return delta;
+}
+
 double
 trackers_velocity(struct pointer_trackers *trackers, uint64_t time);
 
@@ -327,6 +327,7 @@ create_pointer_accelerator_filter_touchpad(int dpi,
 	filter->last_velocity = 0.0;
 
 	trackers_init(&filter->trackers);
+	filter->base.trackers = &filter->trackers;
 
 	filter->threshold = 130;
 	filter->dpi = dpi;
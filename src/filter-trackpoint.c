@@ -207,6 +207,7 @@ create_pointer_accelerator_filter_trackpoint(double multiplier)
 	filter->multiplier = multiplier;
 
 	trackers_init(&filter->trackers);
+	filter->base.trackers = &filter->trackers;
 
 	filter->base.interface = &accelerator_interface_trackpoint;
 
@@ -38,6 +38,14 @@
 
 #define MOTION_TIMEOUT		ms2us(1000)
 
+/* The tracker history covers a time window rather than a fixed number of
+ * events. Devices up to 1000Hz get the minimum number of trackers,
+ * high-frequency devices get more so their velocity isn't calculated from
+ * only the last few ms of motion */
+#define TRACKERS_HISTORY_WINDOW	ms2us(16)
+#define TRACKERS_MIN		16
+#define TRACKERS_MAX		128
+
 struct normalized_coords
 filter_dispatch(struct motion_filter *filter,
 		const struct device_float_coords *unaccelerated,
@@ -62,6 +70,14 @@ filter_restart(struct motion_filter *filter,
 		filter->interface->restart(filter, data, time);
 }
 
+void
+filter_set_report_rate(struct motion_filter *filter,
+		       unsigned int rate)
+{
+	if (filter->trackers)
+		trackers_set_report_rate(filter->trackers, rate);
+}
+
 void
 filter_destroy(struct motion_filter *filter)
 {
@@ -93,12 +109,14 @@ filter_get_type(struct motion_filter *filter)
 void
 trackers_init(struct pointer_trackers *trackers)
 {
-	const int ntrackers = 16;
+	const int ntrackers = TRACKERS_MIN;
 
 	trackers->trackers = zalloc(ntrackers *
 				    sizeof(*trackers->trackers));
 	trackers->ntrackers = ntrackers;
 	trackers->cur_tracker = 0;
+	trackers->pos.x = 0.0;
+	trackers->pos.y = 0.0;
 	trackers->smoothener = NULL;
 }
 
@@ -120,13 +138,18 @@ trackers_reset(struct pointer_trackers *trackers,
 		tracker = trackers_by_offset(trackers, offset);
 		tracker->time = 0;
 		tracker->dir = 0;
-		tracker->delta.x = 0;
-		tracker->delta.y = 0;
+		tracker->pos.x = 0;
+		tracker->pos.y = 0;
 	}
 
 	tracker = trackers_by_offset(trackers, 0);
 	tracker->time = time;
 	tracker->dir = UNDEFINED_DIRECTION;
+	tracker->pos.x = 0;
+	tracker->pos.y = 0;
+
+	trackers->pos.x = 0;
+	trackers->pos.y = 0;
 }
 
 void
@@ -134,25 +157,52 @@ trackers_feed(struct pointer_trackers *trackers,
 	      const struct device_float_coords *delta,
 	      uint64_t time)
 {
-	unsigned int i, current;
+	unsigned int current;
 	struct pointer_tracker *ts = trackers->trackers;
 
 	assert(trackers->ntrackers);
 
-	for (i = 0; i < trackers->ntrackers; i++) {
-		ts[i].delta.x += delta->x;
-		ts[i].delta.y += delta->y;
-	}
+	trackers->pos.x += delta->x;
+	trackers->pos.y += delta->y;
 
 	current = (trackers->cur_tracker + 1) % trackers->ntrackers;
 	trackers->cur_tracker = current;
 
-	ts[current].delta.x = 0.0;
-	ts[current].delta.y = 0.0;
+	ts[current].pos = trackers->pos;
 	ts[current].time = time;
 	ts[current].dir = device_float_get_direction(*delta);
 }
 
+void
+trackers_set_report_rate(struct pointer_trackers *trackers,
+			 unsigned int rate)
+{
+	struct pointer_tracker *ts;
+	size_t ntrackers;
+	unsigned int offset;
+
+	ntrackers = (uint64_t)rate * TRACKERS_HISTORY_WINDOW / s2us(1);
+	ntrackers = max(ntrackers, TRACKERS_MIN);
+	ntrackers = min(ntrackers, TRACKERS_MAX);
+
+	if (ntrackers == trackers->ntrackers)
+		return;
+
+	/* Copy the most recent trackers into the new ring, with the
+	 * current tracker at index 0 */
+	ts = zalloc(ntrackers * sizeof(*ts));
+	for (offset = 0;
+	     offset < min(ntrackers, trackers->ntrackers);
+	     offset++)
+		ts[(ntrackers - offset) % ntrackers] =
+			*trackers_by_offset(trackers, offset);
+
+	free(trackers->trackers);
+	trackers->trackers = ts;
+	trackers->ntrackers = ntrackers;
+	trackers->cur_tracker = 0;
+}
+
 struct pointer_tracker *
 trackers_by_offset(struct pointer_trackers *trackers, unsigned int offset)
 {
@@ -163,22 +213,25 @@ trackers_by_offset(struct pointer_trackers *trackers, unsigned int offset)
 }
 
 static double
-calculate_trackers_velocity(struct pointer_tracker *tracker,
-			   uint64_t time,
-			   struct pointer_delta_smoothener *smoothener)
+calculate_trackers_velocity(struct pointer_trackers *trackers,
+			    struct pointer_tracker *tracker,
+			    uint64_t time)
 {
+	struct pointer_delta_smoothener *smoothener = trackers->smoothener;
+	struct device_float_coords delta;
 	uint64_t tdelta = time - tracker->time + 1;
 
 	if (smoothener && tdelta < smoothener->threshold)
 		tdelta = smoothener->value;
 
-	return hypot(tracker->delta.x, tracker->delta.y) /
-	       (double)tdelta; /* units/us */
+	delta = tracker_delta(trackers, tracker);
+
+	return hypot(delta.x, delta.y) / (double)tdelta; /* units/us */
 }
 
 static double
-trackers_velocity_after_timeout(struct pointer_tracker *tracker,
-				 struct pointer_delta_smoothener *smoothener)
+trackers_velocity_after_timeout(struct pointer_trackers *trackers,
+				struct pointer_tracker *tracker)
 {
 	/* First movement after timeout needs special handling.
 	 *
@@ -191,9 +244,9 @@ trackers_velocity_after_timeout(struct pointer_tracker *tracker,
 	 * for really slow movements but provides much more useful initial
 	 * movement in normal use-cases (pause, move, pause, move)
 	 */
-	return calculate_trackers_velocity(tracker,
-					  tracker->time + MOTION_TIMEOUT,
-					  smoothener);
+	return calculate_trackers_velocity(trackers,
+					   tracker,
+					   tracker->time + MOTION_TIMEOUT);
 }
 
 /**
@@ -202,6 +255,12 @@ trackers_velocity_after_timeout(struct pointer_tracker *tracker,
  * different" to our current one. That includes either being too far in the
  * past, moving into a different direction or having too much of a velocity
  * change between events.
+ *
+ * The velocity is the accumulated motion divided by the time elapsed since
+ * the oldest tracker used, i.e. each event is weighted by its duration,
+ * not counted once. Together with the ring sized by the report rate, see
+ * trackers_set_report_rate(), the result depends on the time window and
+ * not on the number of events within it.
  */
 double
 trackers_velocity(struct pointer_trackers *trackers, uint64_t time)
@@ -229,14 +288,14 @@ trackers_velocity(struct pointer_trackers *trackers, uint64_t time)
 		if (time - tracker->time > MOTION_TIMEOUT) {
 			if (offset == 1)
 				result = trackers_velocity_after_timeout(
-							  tracker,
-							  trackers->smoothener);
+							  trackers,
+							  tracker);
 			break;
 		}
 
-		velocity = calculate_trackers_velocity(tracker,
-						      time,
-						      trackers->smoothener);
+		velocity = calculate_trackers_velocity(trackers,
+						       tracker,
+						       time);
 
 		/* Stop if direction changed */
 		dir &= tracker->dir;
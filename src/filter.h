@@ -86,6 +86,15 @@ void
 filter_restart(struct motion_filter *filter,
 	       void *data, uint64_t time);
 
+/**
+ * Notify the filter of the device's report rate in Hz. Filters that
+ * keep a motion history resize it to cover the same time window at any
+ * report rate.
+ */
+void
+filter_set_report_rate(struct motion_filter *filter,
+		       unsigned int rate);
+
 void
 filter_destroy(struct motion_filter *filter);
 
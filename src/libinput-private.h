@@ -119,8 +119,19 @@ struct libinput {
 		struct libinput_source *source;
 		int fd;
 		uint64_t next_expiry;
+
+		/* timerfd wakeups since wakeups_start, for debugging */
+		unsigned int wakeups;
+		uint64_t wakeups_start;
 	} timer;
 
+	/* id of the frame events are currently generated for, never 0 */
+	uint32_t frame;
+	/* true if an event was posted with the current frame id */
+	bool frame_used;
+	/* true while a device's hardware frame is processed */
+	bool in_frame;
+
 	struct libinput_event **events;
 	size_t events_count;
 	size_t events_len;
@@ -141,6 +152,12 @@ struct libinput {
 
 	uint64_t last_event_time;
 
+	/* event types the caller doesn't want, see
+	 * libinput_set_event_type_enabled() */
+	unsigned long disabled_event_types[NLONGS(LIBINPUT_EVENT_SWITCH_TOGGLE + 1)];
+
+	enum libinput_prediction_method prediction_method;
+
 	bool quirks_initialized;
 	struct quirks_context *quirks;
 };
@@ -158,7 +175,13 @@ struct libinput_seat {
 	char *physical_name;
 	char *logical_name;
 
-	uint32_t slot_map;
+	/* Bitmap of the seat slots in use, grown on demand. All longs
+	 * below first_free are full. */
+	struct {
+		unsigned long *map;
+		size_t nlongs;
+		size_t first_free;
+	} slots;
 
 	uint32_t button_count[KEY_CNT];
 };
@@ -184,6 +207,11 @@ struct libinput_device_config_tap {
 							    enum libinput_config_drag_lock_state);
 	enum libinput_config_drag_lock_state (*get_draglock_enabled)(struct libinput_device *device);
 	enum libinput_config_drag_lock_state (*get_default_draglock_enabled)(struct libinput_device *device);
+
+	enum libinput_config_status (*set_adaptive_timeout_enabled)(struct libinput_device *device,
+								    enum libinput_config_tap_adaptive_timeout_state);
+	enum libinput_config_tap_adaptive_timeout_state (*get_adaptive_timeout_enabled)(struct libinput_device *device);
+	enum libinput_config_tap_adaptive_timeout_state (*get_default_adaptive_timeout_enabled)(struct libinput_device *device);
 };
 
 struct libinput_device_config_calibration {
@@ -262,6 +290,13 @@ struct libinput_device_config_middle_emulation {
 			 struct libinput_device *device);
 	enum libinput_config_middle_emulation_state (*get_default)(
 			 struct libinput_device *device);
+	enum libinput_config_status (*set_adaptive_timeout)(
+			 struct libinput_device *device,
+			 enum libinput_config_middle_emulation_adaptive_timeout_state);
+	enum libinput_config_middle_emulation_adaptive_timeout_state (*get_adaptive_timeout)(
+			 struct libinput_device *device);
+	enum libinput_config_middle_emulation_adaptive_timeout_state (*get_default_adaptive_timeout)(
+			 struct libinput_device *device);
 };
 
 struct libinput_device_config_dwt {
@@ -284,6 +319,15 @@ struct libinput_device_config_rotation {
 	unsigned int (*get_default_angle)(struct libinput_device *device);
 };
 
+struct libinput_device_config_resample {
+	int (*is_available)(struct libinput_device *device);
+	enum libinput_config_status (*set_rate)(
+			 struct libinput_device *device,
+			 unsigned int rate);
+	unsigned int (*get_rate)(struct libinput_device *device);
+	unsigned int (*get_default_rate)(struct libinput_device *device);
+};
+
 struct libinput_device_config {
 	struct libinput_device_config_tap *tap;
 	struct libinput_device_config_calibration *calibration;
@@ -296,6 +340,7 @@ struct libinput_device_config {
 	struct libinput_device_config_middle_emulation *middle_emulation;
 	struct libinput_device_config_dwt *dwt;
 	struct libinput_device_config_rotation *rotation;
+	struct libinput_device_config_resample *resample;
 };
 
 struct libinput_device_group {
@@ -306,6 +351,22 @@ struct libinput_device_group {
 	struct list link;
 };
 
+/* The most recent positions of a touch or tool, newest first */
+struct motion_history {
+	struct {
+		uint64_t time;
+		struct device_coords point;
+	} samples[3];
+	unsigned int count;
+};
+
+/* Extrapolation from an event's position, in device units:
+ * point(time + dt) = point + velocity * dt + curvature * dt², dt in us */
+struct motion_prediction {
+	struct device_float_coords velocity;
+	struct device_float_coords curvature;
+};
+
 struct libinput_device {
 	struct libinput_seat *seat;
 	struct libinput_device_group *group;
@@ -314,6 +375,10 @@ struct libinput_device {
 	void *user_data;
 	int refcount;
 	struct libinput_device_config config;
+
+	/* per-slot history for libinput_set_prediction_method() */
+	struct motion_history *touch_history;
+	size_t touch_history_len;
 };
 
 enum libinput_tablet_tool_axis {
@@ -356,6 +421,10 @@ struct libinput_tablet_tool {
 	struct threshold pressure_threshold;
 	int pressure_offset; /* in device coordinates */
 	bool has_pressure_offset;
+
+	struct motion_history history;
+
+	enum libinput_config_tablet_tool_smoothing smoothing;
 };
 
 struct libinput_tablet_pad_mode_group {
@@ -380,6 +449,7 @@ struct libinput_tablet_pad_mode_group {
 struct libinput_event {
 	enum libinput_event_type type;
 	struct libinput_device *device;
+	uint32_t frame;
 };
 
 struct libinput_event_listener {
@@ -390,7 +460,21 @@ struct libinput_event_listener {
 
 typedef void (*libinput_source_dispatch_t)(void *data);
 
-#define log_debug(li_, ...) log_msg((li_), LIBINPUT_LOG_PRIORITY_DEBUG, __VA_ARGS__)
+static inline bool
+log_is_logged(const struct libinput *libinput,
+	      enum libinput_log_priority priority)
+{
+	return libinput->log_handler &&
+		libinput->log_priority <= priority;
+}
+
+/* Debug messages are the only ones in hot paths, check the priority
+ * before evaluating the arguments */
+#define log_debug(li_, ...) \
+	do { \
+		if (log_is_logged((li_), LIBINPUT_LOG_PRIORITY_DEBUG)) \
+			log_msg((li_), LIBINPUT_LOG_PRIORITY_DEBUG, __VA_ARGS__); \
+	} while (0)
 #define log_info(li_, ...) log_msg((li_), LIBINPUT_LOG_PRIORITY_INFO, __VA_ARGS__)
 #define log_error(li_, ...) log_msg((li_), LIBINPUT_LOG_PRIORITY_ERROR, __VA_ARGS__)
 #define log_bug_kernel(li_, ...) log_msg((li_), LIBINPUT_LOG_PRIORITY_ERROR, "kernel bug: " __VA_ARGS__)
@@ -460,6 +544,12 @@ libinput_seat_init(struct libinput_seat *seat,
 		   const char *logical_name,
 		   libinput_seat_destroy_func destroy);
 
+int
+libinput_seat_acquire_slot(struct libinput_seat *seat);
+
+void
+libinput_seat_release_slot(struct libinput_seat *seat, int seat_slot);
+
 void
 libinput_device_init(struct libinput_device *device,
 		     struct libinput_seat *seat);
@@ -497,6 +587,13 @@ notify_added_device(struct libinput_device *device);
 void
 notify_removed_device(struct libinput_device *device);
 
+static inline bool
+libinput_event_type_is_disabled(struct libinput *libinput,
+				enum libinput_event_type type)
+{
+	return long_bit_is_set(libinput->disabled_event_types, type);
+}
+
 void
 keyboard_notify_key(struct libinput_device *device,
 		    uint64_t time,
@@ -526,7 +623,8 @@ pointer_notify_axis(struct libinput_device *device,
 		    uint32_t axes,
 		    enum libinput_pointer_axis_source source,
 		    const struct normalized_coords *delta,
-		    const struct discrete_coords *discrete);
+		    const struct discrete_coords *discrete,
+		    const struct normalized_coords *velocity);
 
 void
 touch_notify_touch_down(struct libinput_device *device,
@@ -642,6 +740,44 @@ switch_notify_toggle(struct libinput_device *device,
 		     enum libinput_switch sw,
 		     enum libinput_switch_state state);
 
+static inline void
+libinput_next_frame(struct libinput *libinput)
+{
+	if (!libinput->frame_used)
+		return;
+
+	if (++libinput->frame == 0)
+		libinput->frame = 1;
+	libinput->frame_used = false;
+}
+
+/**
+ * Start a hardware frame, called for every evdev event. The first event of
+ * a frame gets a new frame id if the current one was used by events
+ * generated outside a frame, e.g. on suspend or by a configuration change.
+ */
+static inline void
+libinput_begin_frame(struct libinput *libinput)
+{
+	if (libinput->in_frame)
+		return;
+
+	libinput_next_frame(libinput);
+	libinput->in_frame = true;
+}
+
+/**
+ * Finish the current frame. All events generated since the previous call
+ * share a frame id, see libinput_event_get_frame_id(). Call this after
+ * handling a SYN_REPORT or a timer.
+ */
+static inline void
+libinput_end_frame(struct libinput *libinput)
+{
+	libinput_next_frame(libinput);
+	libinput->in_frame = false;
+}
+
 static inline uint64_t
 libinput_now(struct libinput *libinput)
 {
@@ -0,0 +1,62 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIBINPUT_TRACE_H
+#define LIBINPUT_TRACE_H
+
+#include "config.h"
+
+/* Static tracepoints for perf, bpftrace and systemtap, see
+ * tools/libinput-latency.bt for an example consumer. All probes use the
+ * "libinput" provider. Without the usdt build option, the probes compile
+ * to nothing and their arguments are not evaluated.
+ *
+ * An unused probe is a single nop instruction, its arguments are only
+ * loaded into registers.
+ */
+
+#if HAVE_USDT
+#include <sys/sdt.h>
+
+#define libinput_trace(name_) \
+	DTRACE_PROBE(libinput, name_)
+#define libinput_trace1(name_, a_) \
+	DTRACE_PROBE1(libinput, name_, a_)
+#define libinput_trace2(name_, a_, b_) \
+	DTRACE_PROBE2(libinput, name_, a_, b_)
+#define libinput_trace3(name_, a_, b_, c_) \
+	DTRACE_PROBE3(libinput, name_, a_, b_, c_)
+#define libinput_trace4(name_, a_, b_, c_, d_) \
+	DTRACE_PROBE4(libinput, name_, a_, b_, c_, d_)
+#define libinput_trace5(name_, a_, b_, c_, d_, e_) \
+	DTRACE_PROBE5(libinput, name_, a_, b_, c_, d_, e_)
+#else
+#define libinput_trace(name_)
+#define libinput_trace1(name_, a_)
+#define libinput_trace2(name_, a_, b_)
+#define libinput_trace3(name_, a_, b_, c_)
+#define libinput_trace4(name_, a_, b_, c_, d_)
+#define libinput_trace5(name_, a_, b_, c_, d_, e_)
+#endif
+
+#endif /* LIBINPUT_TRACE_H */
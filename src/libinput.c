@@ -39,6 +39,7 @@
 #include "evdev.h"
 #include "timer.h"
 #include "quirks.h"
+#include "libinput-trace.h"
 
 #define require_event_type(li_, type_, retval_, ...)	\
 	if (type_ == LIBINPUT_EVENT_NONE) abort(); \
@@ -69,10 +70,13 @@ ASSERT_INT_SIZE(enum libinput_config_tap_state);
 ASSERT_INT_SIZE(enum libinput_config_tap_button_map);
 ASSERT_INT_SIZE(enum libinput_config_drag_state);
 ASSERT_INT_SIZE(enum libinput_config_drag_lock_state);
+ASSERT_INT_SIZE(enum libinput_config_tap_adaptive_timeout_state);
 ASSERT_INT_SIZE(enum libinput_config_send_events_mode);
 ASSERT_INT_SIZE(enum libinput_config_accel_profile);
 ASSERT_INT_SIZE(enum libinput_config_click_method);
 ASSERT_INT_SIZE(enum libinput_config_middle_emulation_state);
+ASSERT_INT_SIZE(enum libinput_config_middle_emulation_adaptive_timeout_state);
+ASSERT_INT_SIZE(enum libinput_config_tablet_tool_smoothing);
 ASSERT_INT_SIZE(enum libinput_config_scroll_method);
 ASSERT_INT_SIZE(enum libinput_config_dwt_state);
 
@@ -170,6 +174,7 @@ struct libinput_event_pointer {
 	struct device_float_coords delta_raw;
 	struct device_coords absolute;
 	struct discrete_coords discrete;
+	struct normalized_coords velocity; /* per second */
 	uint32_t button;
 	uint32_t seat_button_count;
 	enum libinput_button_state state;
@@ -183,6 +188,7 @@ struct libinput_event_touch {
 	int32_t slot;
 	int32_t seat_slot;
 	struct device_coords point;
+	struct motion_prediction prediction;
 };
 
 struct libinput_event_gesture {
@@ -207,6 +213,7 @@ struct libinput_event_tablet_tool {
 	struct libinput_tablet_tool *tool;
 	enum libinput_tablet_tool_proximity_state proximity_state;
 	enum libinput_tablet_tool_tip_state tip_state;
+	struct motion_prediction prediction;
 };
 
 struct libinput_event_tablet_pad {
@@ -237,6 +244,105 @@ struct libinput_event_switch {
 	enum libinput_switch_state state;
 };
 
+/* Extrapolating further ahead than this is mostly noise */
+#define PREDICTION_MAX_HORIZON ms2us(50)
+/* Samples further apart than this straddle a pause in the motion */
+#define PREDICTION_MAX_SAMPLE_GAP ms2us(50)
+
+static inline void
+motion_history_reset(struct motion_history *history)
+{
+	history->count = 0;
+}
+
+static void
+motion_history_push(struct motion_history *history,
+		    uint64_t time,
+		    const struct device_coords *point)
+{
+	size_t sz = ARRAY_LENGTH(history->samples);
+
+	/* Several events of the same frame share the timestamp */
+	if (history->count > 0 && history->samples[0].time == time) {
+		history->samples[0].point = *point;
+		return;
+	}
+
+	memmove(&history->samples[1],
+		&history->samples[0],
+		(sz - 1) * sizeof(history->samples[0]));
+	history->samples[0].time = time;
+	history->samples[0].point = *point;
+	history->count = min(history->count + 1, sz);
+}
+
+static struct motion_prediction
+motion_history_predict(const struct motion_history *history,
+		       enum libinput_prediction_method method)
+{
+	struct motion_prediction prediction = { { 0, 0 }, { 0, 0 } };
+	struct device_float_coords v01, v12, c;
+	uint64_t t0, t1, t2;
+
+	if (method == LIBINPUT_PREDICTION_NONE || history->count < 2)
+		return prediction;
+
+	t0 = history->samples[0].time;
+	t1 = history->samples[1].time;
+	if (t0 <= t1 || t0 - t1 > PREDICTION_MAX_SAMPLE_GAP)
+		return prediction;
+
+	v01.x = (history->samples[0].point.x - history->samples[1].point.x) /
+		(double)(t0 - t1);
+	v01.y = (history->samples[0].point.y - history->samples[1].point.y) /
+		(double)(t0 - t1);
+	prediction.velocity = v01;
+
+	if (method != LIBINPUT_PREDICTION_QUADRATIC || history->count < 3)
+		return prediction;
+
+	t2 = history->samples[2].time;
+	if (t1 <= t2 || t1 - t2 > PREDICTION_MAX_SAMPLE_GAP)
+		return prediction;
+
+	v12.x = (history->samples[1].point.x - history->samples[2].point.x) /
+		(double)(t1 - t2);
+	v12.y = (history->samples[1].point.y - history->samples[2].point.y) /
+		(double)(t1 - t2);
+
+	/* Newton form of the parabola through the three samples:
+	 * p(t0 + dt) = p0 + v01 * dt + c * dt * (dt + t0 - t1) */
+	c.x = (v01.x - v12.x) / (t0 - t2);
+	c.y = (v01.y - v12.y) / (t0 - t2);
+	prediction.curvature = c;
+	prediction.velocity.x = v01.x + c.x * (t0 - t1);
+	prediction.velocity.y = v01.y + c.y * (t0 - t1);
+
+	return prediction;
+}
+
+static struct device_float_coords
+motion_prediction_get_point(const struct motion_prediction *prediction,
+			    const struct device_coords *point,
+			    uint64_t time,
+			    uint64_t target_time)
+{
+	struct device_float_coords p;
+	double dt = 0;
+
+	if (target_time > time)
+		dt = min(target_time - time, PREDICTION_MAX_HORIZON);
+
+	p.x = point->x +
+	      prediction->velocity.x * dt +
+	      prediction->curvature.x * dt * dt;
+	p.y = point->y +
+	      prediction->velocity.y * dt +
+	      prediction->curvature.y * dt * dt;
+
+	return p;
+}
+
 LIBINPUT_ATTRIBUTE_PRINTF(3, 0)
 static void
 libinput_default_log_func(struct libinput *libinput,
@@ -262,8 +368,7 @@ log_msg_va(struct libinput *libinput,
 	   const char *format,
 	   va_list args)
 {
-	if (libinput->log_handler &&
-	    libinput->log_priority <= priority)
+	if (log_is_logged(libinput, priority))
 		libinput->log_handler(libinput, priority, format, args);
 }
 
@@ -288,6 +393,9 @@ log_msg_ratelimit(struct libinput *libinput,
 	va_list args;
 	enum ratelimit_state state;
 
+	if (!log_is_logged(libinput, priority))
+		return;
+
 	state = ratelimit_test(ratelimit);
 	if (state == RATELIMIT_EXCEEDED)
 		return;
@@ -349,6 +457,12 @@ libinput_event_get_device(struct libinput_event *event)
 	return event->device;
 }
 
+LIBINPUT_EXPORT uint32_t
+libinput_event_get_frame_id(struct libinput_event *event)
+{
+	return event->frame;
+}
+
 LIBINPUT_EXPORT struct libinput_event_pointer *
 libinput_event_get_pointer_event(struct libinput_event *event)
 {
@@ -720,6 +834,34 @@ libinput_event_pointer_get_axis_value(struct libinput_event_pointer *event,
 	return value;
 }
 
+LIBINPUT_EXPORT double
+libinput_event_pointer_get_axis_velocity(struct libinput_event_pointer *event,
+					 enum libinput_pointer_axis axis)
+{
+	struct libinput *libinput = event->base.device->seat->libinput;
+	double value = 0;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0.0,
+			   LIBINPUT_EVENT_POINTER_AXIS);
+
+	if (!libinput_event_pointer_has_axis(event, axis)) {
+		log_bug_client(libinput, "velocity requested for unset axis\n");
+	} else {
+		switch (axis) {
+		case LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL:
+			value = event->velocity.x;
+			break;
+		case LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL:
+			value = event->velocity.y;
+			break;
+		}
+	}
+
+	return value;
+}
+
 LIBINPUT_EXPORT double
 libinput_event_pointer_get_axis_value_discrete(struct libinput_event_pointer *event,
 					       enum libinput_pointer_axis axis)
@@ -860,6 +1002,50 @@ libinput_event_touch_get_y_transformed(struct libinput_event_touch *event,
 	return evdev_device_transform_y(device, event->point.y, height);
 }
 
+LIBINPUT_EXPORT double
+libinput_event_touch_get_predicted_x_transformed(struct libinput_event_touch *event,
+						 uint64_t time_usec,
+						 uint32_t width)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	struct device_float_coords point;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_DOWN,
+			   LIBINPUT_EVENT_TOUCH_MOTION);
+
+	point = motion_prediction_get_point(&event->prediction,
+					    &event->point,
+					    event->time,
+					    time_usec);
+
+	return evdev_device_transform_x(device, point.x, width);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_get_predicted_y_transformed(struct libinput_event_touch *event,
+						 uint64_t time_usec,
+						 uint32_t height)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	struct device_float_coords point;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_DOWN,
+			   LIBINPUT_EVENT_TOUCH_MOTION);
+
+	point = motion_prediction_get_point(&event->prediction,
+					    &event->point,
+					    event->time,
+					    time_usec);
+
+	return evdev_device_transform_y(device, point.y, height);
+}
+
 LIBINPUT_EXPORT double
 libinput_event_touch_get_y(struct libinput_event_touch *event)
 {
@@ -1383,6 +1569,54 @@ libinput_event_tablet_tool_get_y_transformed(struct libinput_event_tablet_tool *
 					height);
 }
 
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_predicted_x_transformed(struct libinput_event_tablet_tool *event,
+						       uint64_t time_usec,
+						       uint32_t width)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	struct device_float_coords point;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
+			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+
+	point = motion_prediction_get_point(&event->prediction,
+					    &event->axes.point,
+					    event->time,
+					    time_usec);
+
+	return evdev_device_transform_x(device, point.x, width);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_predicted_y_transformed(struct libinput_event_tablet_tool *event,
+						       uint64_t time_usec,
+						       uint32_t height)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	struct device_float_coords point;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
+			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+
+	point = motion_prediction_get_point(&event->prediction,
+					    &event->axes.point,
+					    event->time,
+					    time_usec);
+
+	return evdev_device_transform_y(device, point.y, height);
+}
+
 LIBINPUT_EXPORT struct libinput_tablet_tool *
 libinput_event_tablet_tool_get_tool(struct libinput_event_tablet_tool *event)
 {
@@ -1711,6 +1945,7 @@ libinput_init(struct libinput *libinput,
 	list_init(&libinput->seat_list);
 	list_init(&libinput->device_group_list);
 	list_init(&libinput->tool_list);
+	libinput->frame = 1;
 
 	if (libinput_timer_subsys_init(libinput) != 0) {
 		free(libinput->events);
@@ -1929,10 +2164,61 @@ libinput_seat_ref(struct libinput_seat *seat)
 	return seat;
 }
 
+/* Return the lowest free seat slot and mark it as in use. The slot
+ * bitmap grows as needed, so there is no upper limit on the number of
+ * concurrent touches in a seat.
+ */
+int
+libinput_seat_acquire_slot(struct libinput_seat *seat)
+{
+	size_t i;
+	unsigned long free_bits;
+	int seat_slot;
+
+	for (i = seat->slots.first_free; i < seat->slots.nlongs; i++) {
+		if (~seat->slots.map[i] != 0)
+			break;
+	}
+
+	if (i == seat->slots.nlongs) {
+		size_t nlongs = max(seat->slots.nlongs * 2, 1);
+		unsigned long *map = zalloc(nlongs * sizeof(*map));
+
+		if (seat->slots.map) {
+			memcpy(map,
+			       seat->slots.map,
+			       seat->slots.nlongs * sizeof(*map));
+			free(seat->slots.map);
+		}
+		seat->slots.map = map;
+		seat->slots.nlongs = nlongs;
+	}
+
+	seat->slots.first_free = i;
+
+	free_bits = ~seat->slots.map[i];
+	seat_slot = i * LONG_BITS + __builtin_ctzl(free_bits);
+	long_set_bit(seat->slots.map, seat_slot);
+
+	return seat_slot;
+}
+
+void
+libinput_seat_release_slot(struct libinput_seat *seat, int seat_slot)
+{
+	size_t i = seat_slot / LONG_BITS;
+
+	assert(i < seat->slots.nlongs);
+
+	long_clear_bit(seat->slots.map, seat_slot);
+	seat->slots.first_free = min(seat->slots.first_free, i);
+}
+
 static void
 libinput_seat_destroy(struct libinput_seat *seat)
 {
 	list_remove(&seat->link);
+	free(seat->slots.map);
 	free(seat->logical_name);
 	free(seat->physical_name);
 	seat->destroy(seat);
@@ -2001,6 +2287,7 @@ static void
 libinput_device_destroy(struct libinput_device *device)
 {
 	assert(list_empty(&device->event_listeners));
+	free(device->touch_history);
 	evdev_device_destroy(evdev_device(device));
 }
 
@@ -2030,9 +2317,17 @@ libinput_dispatch(struct libinput *libinput)
 	struct epoll_event ep[32];
 	int i, count;
 
+	libinput_trace1(dispatch_begin, libinput);
+
+	/* events posted since the last dispatch, e.g. on suspend, are a
+	 * frame of their own */
+	libinput_end_frame(libinput);
+
 	count = epoll_wait(libinput->epoll_fd, ep, ARRAY_LENGTH(ep), 0);
-	if (count < 0)
+	if (count < 0) {
+		libinput_trace1(dispatch_end, libinput);
 		return -errno;
+	}
 
 	for (i = 0; i < count; ++i) {
 		source = ep[i].data.ptr;
@@ -2044,6 +2339,8 @@ libinput_dispatch(struct libinput *libinput)
 
 	libinput_drop_destroyed_sources(libinput);
 
+	libinput_trace1(dispatch_end, libinput);
+
 	return 0;
 }
 
@@ -2134,6 +2431,21 @@ post_base_event(struct libinput_device *device,
 	libinput_post_event(libinput, event);
 }
 
+/**
+ * Check whether an event of the given type needs to be created at all.
+ * Internal listeners get the event even if the caller has disabled the
+ * type, so we can only skip it if there are none.
+ */
+static inline bool
+event_type_wanted(struct libinput_device *device,
+		  enum libinput_event_type type)
+{
+	struct libinput *libinput = device->seat->libinput;
+
+	return !libinput_event_type_is_disabled(libinput, type) ||
+		!list_empty(&device->event_listeners);
+}
+
 static void
 post_device_event(struct libinput_device *device,
 		  uint64_t time,
@@ -2154,10 +2466,20 @@ post_device_event(struct libinput_device *device,
 #endif
 
 	init_event_base(event, device, type);
+	event->frame = device->seat->libinput->frame;
+	device->seat->libinput->frame_used = true;
 
 	list_for_each_safe(listener, tmp, &device->event_listeners, link)
 		listener->notify_func(time, event, listener->notify_func_data);
 
+	if (libinput_event_type_is_disabled(device->seat->libinput, type)) {
+		libinput_event_destroy(event);
+		return;
+	}
+
+	/* only for queued events, the script keys on the event pointer */
+	libinput_trace5(post_event, device, type, event->frame, time, event);
+
 	libinput_post_event(device->seat->libinput, event);
 }
 
@@ -2168,6 +2490,10 @@ notify_added_device(struct libinput_device *device)
 
 	added_device_event = zalloc(sizeof *added_device_event);
 
+	libinput_trace2(device_added,
+			device,
+			libinput_device_get_sysname(device));
+
 	post_base_event(device,
 			LIBINPUT_EVENT_DEVICE_ADDED,
 			&added_device_event->base);
@@ -2186,6 +2512,10 @@ notify_removed_device(struct libinput_device *device)
 
 	removed_device_event = zalloc(sizeof *removed_device_event);
 
+	libinput_trace2(device_removed,
+			device,
+			libinput_device_get_sysname(device));
+
 	post_base_event(device,
 			LIBINPUT_EVENT_DEVICE_REMOVED,
 			&removed_device_event->base);
@@ -2250,10 +2580,13 @@ keyboard_notify_key(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_KEYBOARD))
 		return;
 
-	key_event = zalloc(sizeof *key_event);
-
 	seat_key_count = update_seat_key_count(device->seat, key, state);
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_KEYBOARD_KEY))
+		return;
+
+	key_event = zalloc(sizeof *key_event);
+
 	*key_event = (struct libinput_event_keyboard) {
 		.time = time,
 		.key = key,
@@ -2277,6 +2610,9 @@ pointer_notify_motion(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_MOTION))
+		return;
+
 	motion_event = zalloc(sizeof *motion_event);
 
 	*motion_event = (struct libinput_event_pointer) {
@@ -2300,6 +2636,9 @@ pointer_notify_motion_absolute(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE))
+		return;
+
 	motion_absolute_event = zalloc(sizeof *motion_absolute_event);
 
 	*motion_absolute_event = (struct libinput_event_pointer) {
@@ -2324,12 +2663,15 @@ pointer_notify_button(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	button_event = zalloc(sizeof *button_event);
-
 	seat_button_count = update_seat_button_count(device->seat,
 						     button,
 						     state);
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_BUTTON))
+		return;
+
+	button_event = zalloc(sizeof *button_event);
+
 	*button_event = (struct libinput_event_pointer) {
 		.time = time,
 		.button = button,
@@ -2348,13 +2690,17 @@ pointer_notify_axis(struct libinput_device *device,
 		    uint32_t axes,
 		    enum libinput_pointer_axis_source source,
 		    const struct normalized_coords *delta,
-		    const struct discrete_coords *discrete)
+		    const struct discrete_coords *discrete,
+		    const struct normalized_coords *velocity)
 {
 	struct libinput_event_pointer *axis_event;
 
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_AXIS))
+		return;
+
 	axis_event = zalloc(sizeof *axis_event);
 
 	*axis_event = (struct libinput_event_pointer) {
@@ -2363,6 +2709,7 @@ pointer_notify_axis(struct libinput_device *device,
 		.source = source,
 		.axes = axes,
 		.discrete = *discrete,
+		.velocity = *velocity,
 	};
 
 	post_device_event(device, time,
@@ -2370,6 +2717,44 @@ pointer_notify_axis(struct libinput_device *device,
 			  &axis_event->base);
 }
 
+static struct motion_prediction
+touch_update_history(struct libinput_device *device,
+		     int32_t slot,
+		     uint64_t time,
+		     const struct device_coords *point,
+		     bool is_down)
+{
+	enum libinput_prediction_method method;
+	struct motion_history *history;
+	/* single-touch devices use slot -1 */
+	size_t idx = slot < 0 ? 0 : slot;
+
+	method = device->seat->libinput->prediction_method;
+	if (method == LIBINPUT_PREDICTION_NONE)
+		return (struct motion_prediction) { { 0, 0 }, { 0, 0 } };
+
+	if (idx >= device->touch_history_len) {
+		size_t len = max(device->touch_history_len * 2, idx + 1);
+
+		history = zalloc(len * sizeof(*history));
+		if (device->touch_history) {
+			memcpy(history,
+			       device->touch_history,
+			       device->touch_history_len * sizeof(*history));
+			free(device->touch_history);
+		}
+		device->touch_history = history;
+		device->touch_history_len = len;
+	}
+
+	history = &device->touch_history[idx];
+	if (is_down)
+		motion_history_reset(history);
+	motion_history_push(history, time, point);
+
+	return motion_history_predict(history, method);
+}
+
 void
 touch_notify_touch_down(struct libinput_device *device,
 			uint64_t time,
@@ -2378,10 +2763,16 @@ touch_notify_touch_down(struct libinput_device *device,
 			const struct device_coords *point)
 {
 	struct libinput_event_touch *touch_event;
+	struct motion_prediction prediction;
 
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
+	prediction = touch_update_history(device, slot, time, point, true);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_DOWN))
+		return;
+
 	touch_event = zalloc(sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
@@ -2389,6 +2780,7 @@ touch_notify_touch_down(struct libinput_device *device,
 		.slot = slot,
 		.seat_slot = seat_slot,
 		.point = *point,
+		.prediction = prediction,
 	};
 
 	post_device_event(device, time,
@@ -2404,10 +2796,16 @@ touch_notify_touch_motion(struct libinput_device *device,
 			  const struct device_coords *point)
 {
 	struct libinput_event_touch *touch_event;
+	struct motion_prediction prediction;
 
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
+	prediction = touch_update_history(device, slot, time, point, false);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_MOTION))
+		return;
+
 	touch_event = zalloc(sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
@@ -2415,6 +2813,7 @@ touch_notify_touch_motion(struct libinput_device *device,
 		.slot = slot,
 		.seat_slot = seat_slot,
 		.point = *point,
+		.prediction = prediction,
 	};
 
 	post_device_event(device, time,
@@ -2433,6 +2832,9 @@ touch_notify_touch_up(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_UP))
+		return;
+
 	touch_event = zalloc(sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
@@ -2455,6 +2857,9 @@ touch_notify_frame(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_FRAME))
+		return;
+
 	touch_event = zalloc(sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
@@ -2466,6 +2871,26 @@ touch_notify_frame(struct libinput_device *device,
 			  &touch_event->base);
 }
 
+static struct motion_prediction
+tablet_tool_update_history(struct libinput_device *device,
+			   struct libinput_tablet_tool *tool,
+			   uint64_t time,
+			   const struct tablet_axes *axes,
+			   bool reset)
+{
+	enum libinput_prediction_method method;
+
+	method = device->seat->libinput->prediction_method;
+	if (method == LIBINPUT_PREDICTION_NONE)
+		return (struct motion_prediction) { { 0, 0 }, { 0, 0 } };
+
+	if (reset)
+		motion_history_reset(&tool->history);
+	motion_history_push(&tool->history, time, &axes->point);
+
+	return motion_history_predict(&tool->history, method);
+}
+
 void
 tablet_notify_axis(struct libinput_device *device,
 		   uint64_t time,
@@ -2475,6 +2900,12 @@ tablet_notify_axis(struct libinput_device *device,
 		   const struct tablet_axes *axes)
 {
 	struct libinput_event_tablet_tool *axis_event;
+	struct motion_prediction prediction;
+
+	prediction = tablet_tool_update_history(device, tool, time, axes, false);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_AXIS))
+		return;
 
 	axis_event = zalloc(sizeof *axis_event);
 
@@ -2484,6 +2915,7 @@ tablet_notify_axis(struct libinput_device *device,
 		.proximity_state = LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN,
 		.tip_state = tip_state,
 		.axes = *axes,
+		.prediction = prediction,
 	};
 
 	memcpy(axis_event->changed_axes,
@@ -2505,6 +2937,18 @@ tablet_notify_proximity(struct libinput_device *device,
 			const struct tablet_axes *axes)
 {
 	struct libinput_event_tablet_tool *proximity_event;
+	struct motion_prediction prediction;
+	bool prox_in;
+
+	prox_in = proximity_state == LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN;
+	prediction = tablet_tool_update_history(device,
+						tool,
+						time,
+						axes,
+						prox_in);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY))
+		return;
 
 	proximity_event = zalloc(sizeof *proximity_event);
 
@@ -2514,6 +2958,7 @@ tablet_notify_proximity(struct libinput_device *device,
 		.tip_state = LIBINPUT_TABLET_TOOL_TIP_UP,
 		.proximity_state = proximity_state,
 		.axes = *axes,
+		.prediction = prediction,
 	};
 	memcpy(proximity_event->changed_axes,
 	       changed_axes,
@@ -2534,6 +2979,12 @@ tablet_notify_tip(struct libinput_device *device,
 		  const struct tablet_axes *axes)
 {
 	struct libinput_event_tablet_tool *tip_event;
+	struct motion_prediction prediction;
+
+	prediction = tablet_tool_update_history(device, tool, time, axes, false);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_TIP))
+		return;
 
 	tip_event = zalloc(sizeof *tip_event);
 
@@ -2543,6 +2994,7 @@ tablet_notify_tip(struct libinput_device *device,
 		.tip_state = tip_state,
 		.proximity_state = LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN,
 		.axes = *axes,
+		.prediction = prediction,
 	};
 	memcpy(tip_event->changed_axes,
 	       changed_axes,
@@ -2564,14 +3016,20 @@ tablet_notify_button(struct libinput_device *device,
 		     enum libinput_button_state state)
 {
 	struct libinput_event_tablet_tool *button_event;
+	struct motion_prediction prediction;
 	int32_t seat_button_count;
 
-	button_event = zalloc(sizeof *button_event);
-
 	seat_button_count = update_seat_button_count(device->seat,
 						     button,
 						     state);
 
+	prediction = tablet_tool_update_history(device, tool, time, axes, false);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_BUTTON))
+		return;
+
+	button_event = zalloc(sizeof *button_event);
+
 	*button_event = (struct libinput_event_tablet_tool) {
 		.time = time,
 		.tool = libinput_tablet_tool_ref(tool),
@@ -2581,6 +3039,7 @@ tablet_notify_button(struct libinput_device *device,
 		.proximity_state = LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN,
 		.tip_state = tip_state,
 		.axes = *axes,
+		.prediction = prediction,
 	};
 
 	post_device_event(device,
@@ -2599,6 +3058,9 @@ tablet_pad_notify_button(struct libinput_device *device,
 	struct libinput_event_tablet_pad *button_event;
 	unsigned int mode;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_BUTTON))
+		return;
+
 	button_event = zalloc(sizeof *button_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
@@ -2628,6 +3090,9 @@ tablet_pad_notify_ring(struct libinput_device *device,
 	struct libinput_event_tablet_pad *ring_event;
 	unsigned int mode;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_RING))
+		return;
+
 	ring_event = zalloc(sizeof *ring_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
@@ -2658,6 +3123,9 @@ tablet_pad_notify_strip(struct libinput_device *device,
 	struct libinput_event_tablet_pad *strip_event;
 	unsigned int mode;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_STRIP))
+		return;
+
 	strip_event = zalloc(sizeof *strip_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
@@ -2693,6 +3161,9 @@ gesture_notify(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_GESTURE))
 		return;
 
+	if (!event_type_wanted(device, type))
+		return;
+
 	gesture_event = zalloc(sizeof *gesture_event);
 
 	*gesture_event = (struct libinput_event_gesture) {
@@ -2771,6 +3242,9 @@ switch_notify_toggle(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_SWITCH))
 		return;
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_SWITCH_TOGGLE))
+		return;
+
 	switch_event = zalloc(sizeof *switch_event);
 
 	*switch_event = (struct libinput_event_switch) {
@@ -2856,6 +3330,12 @@ libinput_get_event(struct libinput *libinput)
 		(libinput->events_out + 1) % libinput->events_len;
 	libinput->events_count--;
 
+	libinput_trace4(get_event,
+			event->device,
+			event->type,
+			event->frame,
+			event);
+
 	return event;
 }
 
@@ -2871,6 +3351,377 @@ libinput_next_event_type(struct libinput *libinput)
 	return event->type;
 }
 
+static inline bool
+event_type_is_valid(enum libinput_event_type type)
+{
+	return type != LIBINPUT_EVENT_NONE &&
+	       type <= LIBINPUT_EVENT_SWITCH_TOGGLE &&
+	       event_type_to_str(type) != NULL;
+}
+
+LIBINPUT_EXPORT int
+libinput_set_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type,
+				int enabled)
+{
+	enum libinput_event_type first, last, t;
+
+	if (!event_type_is_valid(type))
+		return -1;
+
+	/* The event types of a sequence are enabled and disabled together,
+	 * otherwise the caller would see touches that never end or
+	 * gestures that never begin */
+	switch (type) {
+	case LIBINPUT_EVENT_DEVICE_ADDED:
+	case LIBINPUT_EVENT_DEVICE_REMOVED:
+		return enabled ? 0 : -1;
+	case LIBINPUT_EVENT_TOUCH_DOWN:
+	case LIBINPUT_EVENT_TOUCH_UP:
+	case LIBINPUT_EVENT_TOUCH_MOTION:
+	case LIBINPUT_EVENT_TOUCH_CANCEL:
+		first = LIBINPUT_EVENT_TOUCH_DOWN;
+		last = LIBINPUT_EVENT_TOUCH_CANCEL;
+		break;
+	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+		first = LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN;
+		last = LIBINPUT_EVENT_GESTURE_SWIPE_END;
+		break;
+	case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_PINCH_END:
+		first = LIBINPUT_EVENT_GESTURE_PINCH_BEGIN;
+		last = LIBINPUT_EVENT_GESTURE_PINCH_END;
+		break;
+	default:
+		first = type;
+		last = type;
+		break;
+	}
+
+	for (t = first; t <= last; t++)
+		long_set_bit_state(libinput->disabled_event_types, t, !enabled);
+
+	return 0;
+}
+
+LIBINPUT_EXPORT int
+libinput_get_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type)
+{
+	if (!event_type_is_valid(type))
+		return -1;
+
+	return !libinput_event_type_is_disabled(libinput, type);
+}
+
+LIBINPUT_EXPORT int
+libinput_set_prediction_method(struct libinput *libinput,
+			       enum libinput_prediction_method method)
+{
+	switch (method) {
+	case LIBINPUT_PREDICTION_NONE:
+	case LIBINPUT_PREDICTION_LINEAR:
+	case LIBINPUT_PREDICTION_QUADRATIC:
+		break;
+	default:
+		return -1;
+	}
+
+	libinput->prediction_method = method;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT enum libinput_prediction_method
+libinput_get_prediction_method(struct libinput *libinput)
+{
+	return libinput->prediction_method;
+}
+
+static void
+event_get_pointer_data(struct libinput_event_pointer *event,
+		       struct libinput_event_data *data)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+
+	switch (event->base.type) {
+	case LIBINPUT_EVENT_POINTER_MOTION:
+		data->u.pointer.dx = event->delta.x;
+		data->u.pointer.dy = event->delta.y;
+		data->u.pointer.dx_unaccelerated = event->delta_raw.x;
+		data->u.pointer.dy_unaccelerated = event->delta_raw.y;
+		break;
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+		data->u.pointer.absolute_x =
+			evdev_convert_to_mm(device->abs.absinfo_x,
+					    event->absolute.x);
+		data->u.pointer.absolute_y =
+			evdev_convert_to_mm(device->abs.absinfo_y,
+					    event->absolute.y);
+		break;
+	case LIBINPUT_EVENT_POINTER_BUTTON:
+		data->u.pointer.button = event->button;
+		data->u.pointer.state = event->state;
+		data->u.pointer.seat_button_count = event->seat_button_count;
+		break;
+	case LIBINPUT_EVENT_POINTER_AXIS:
+		data->u.pointer.axis_source = event->source;
+		data->u.pointer.axes = event->axes;
+		data->u.pointer.scroll_vertical = event->delta.y;
+		data->u.pointer.scroll_horizontal = event->delta.x;
+		data->u.pointer.scroll_vertical_discrete = event->discrete.y;
+		data->u.pointer.scroll_horizontal_discrete = event->discrete.x;
+		data->u.pointer.scroll_vertical_velocity = event->velocity.y;
+		data->u.pointer.scroll_horizontal_velocity = event->velocity.x;
+		break;
+	default:
+		abort();
+	}
+}
+
+static void
+event_get_tablet_tool_data(struct libinput_event_tablet_tool *event,
+			   struct libinput_event_data *data)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct tablet_axes *axes = &event->axes;
+	enum libinput_tablet_tool_axis axis;
+
+	data->u.tablet_tool.tool_type = event->tool->type;
+	data->u.tablet_tool.tool_serial = event->tool->serial;
+	data->u.tablet_tool.tool_id = event->tool->tool_id;
+	data->u.tablet_tool.proximity_state = event->proximity_state;
+	data->u.tablet_tool.tip_state = event->tip_state;
+
+	if (event->base.type == LIBINPUT_EVENT_TABLET_TOOL_BUTTON) {
+		data->u.tablet_tool.button = event->button;
+		data->u.tablet_tool.button_state = event->state;
+		data->u.tablet_tool.seat_button_count =
+			event->seat_button_count;
+	}
+
+	for (axis = LIBINPUT_TABLET_TOOL_AXIS_X;
+	     axis <= LIBINPUT_TABLET_TOOL_AXIS_MAX;
+	     axis++) {
+		if (bit_is_set(event->changed_axes, axis))
+			data->u.tablet_tool.changed |= 1 << axis;
+	}
+
+	data->u.tablet_tool.x = evdev_convert_to_mm(device->abs.absinfo_x,
+						    axes->point.x);
+	data->u.tablet_tool.y = evdev_convert_to_mm(device->abs.absinfo_y,
+						    axes->point.y);
+	data->u.tablet_tool.dx = axes->delta.x;
+	data->u.tablet_tool.dy = axes->delta.y;
+	data->u.tablet_tool.pressure = axes->pressure;
+	data->u.tablet_tool.distance = axes->distance;
+	data->u.tablet_tool.tilt_x = axes->tilt.x;
+	data->u.tablet_tool.tilt_y = axes->tilt.y;
+	data->u.tablet_tool.rotation = axes->rotation;
+	data->u.tablet_tool.slider = axes->slider;
+	data->u.tablet_tool.wheel_delta = axes->wheel;
+	data->u.tablet_tool.wheel_delta_discrete = axes->wheel_discrete;
+}
+
+static void
+event_get_tablet_pad_data(struct libinput_event_tablet_pad *event,
+			  struct libinput_event_data *data)
+{
+	data->u.tablet_pad.mode = event->mode;
+
+	switch (event->base.type) {
+	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
+		data->u.tablet_pad.button = event->button.number;
+		data->u.tablet_pad.button_state = event->button.state;
+		break;
+	case LIBINPUT_EVENT_TABLET_PAD_RING:
+		data->u.tablet_pad.ring_number = event->ring.number;
+		data->u.tablet_pad.ring_position = event->ring.position;
+		data->u.tablet_pad.ring_source = event->ring.source;
+		break;
+	case LIBINPUT_EVENT_TABLET_PAD_STRIP:
+		data->u.tablet_pad.strip_number = event->strip.number;
+		data->u.tablet_pad.strip_position = event->strip.position;
+		data->u.tablet_pad.strip_source = event->strip.source;
+		break;
+	default:
+		abort();
+	}
+}
+
+static int
+event_fill_data(struct libinput_event *event,
+		struct libinput_event_data *data)
+{
+	struct evdev_device *device;
+	struct libinput_event_keyboard *key;
+	struct libinput_event_pointer *pointer;
+	struct libinput_event_touch *touch;
+	struct libinput_event_gesture *gesture;
+	struct libinput_event_tablet_tool *tool;
+	struct libinput_event_tablet_pad *pad;
+	struct libinput_event_switch *sw;
+
+	memset(data, 0, sizeof(*data));
+
+	data->type = event->type;
+	data->device = event->device;
+	data->frame_id = event->frame;
+
+	switch (event->type) {
+	case LIBINPUT_EVENT_NONE:
+		return -1;
+	case LIBINPUT_EVENT_DEVICE_ADDED:
+	case LIBINPUT_EVENT_DEVICE_REMOVED:
+		break;
+	case LIBINPUT_EVENT_KEYBOARD_KEY:
+		key = (struct libinput_event_keyboard *)event;
+		data->time_usec = key->time;
+		data->u.keyboard.key = key->key;
+		data->u.keyboard.state = key->state;
+		data->u.keyboard.seat_key_count = key->seat_key_count;
+		break;
+	case LIBINPUT_EVENT_POINTER_MOTION:
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+	case LIBINPUT_EVENT_POINTER_BUTTON:
+	case LIBINPUT_EVENT_POINTER_AXIS:
+		pointer = (struct libinput_event_pointer *)event;
+		data->time_usec = pointer->time;
+		event_get_pointer_data(pointer, data);
+		break;
+	case LIBINPUT_EVENT_TOUCH_DOWN:
+	case LIBINPUT_EVENT_TOUCH_MOTION:
+		device = evdev_device(event->device);
+		touch = (struct libinput_event_touch *)event;
+		data->u.touch.x = evdev_convert_to_mm(device->abs.absinfo_x,
+						      touch->point.x);
+		data->u.touch.y = evdev_convert_to_mm(device->abs.absinfo_y,
+						      touch->point.y);
+		/* fallthrough */
+	case LIBINPUT_EVENT_TOUCH_UP:
+	case LIBINPUT_EVENT_TOUCH_CANCEL:
+		touch = (struct libinput_event_touch *)event;
+		data->u.touch.slot = touch->slot;
+		data->u.touch.seat_slot = touch->seat_slot;
+		data->time_usec = touch->time;
+		break;
+	case LIBINPUT_EVENT_TOUCH_FRAME:
+		touch = (struct libinput_event_touch *)event;
+		data->time_usec = touch->time;
+		break;
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
+	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
+	case LIBINPUT_EVENT_TABLET_TOOL_TIP:
+	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
+		tool = (struct libinput_event_tablet_tool *)event;
+		data->time_usec = tool->time;
+		event_get_tablet_tool_data(tool, data);
+		break;
+	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
+	case LIBINPUT_EVENT_TABLET_PAD_RING:
+	case LIBINPUT_EVENT_TABLET_PAD_STRIP:
+		pad = (struct libinput_event_tablet_pad *)event;
+		data->time_usec = pad->time;
+		event_get_tablet_pad_data(pad, data);
+		break;
+	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+	case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_PINCH_END:
+		gesture = (struct libinput_event_gesture *)event;
+		data->time_usec = gesture->time;
+		data->u.gesture.finger_count = gesture->finger_count;
+		data->u.gesture.cancelled = gesture->cancelled;
+		data->u.gesture.dx = gesture->delta.x;
+		data->u.gesture.dy = gesture->delta.y;
+		data->u.gesture.dx_unaccelerated = gesture->delta_unaccel.x;
+		data->u.gesture.dy_unaccelerated = gesture->delta_unaccel.y;
+		data->u.gesture.scale = gesture->scale;
+		data->u.gesture.angle_delta = gesture->angle;
+		break;
+	case LIBINPUT_EVENT_SWITCH_TOGGLE:
+		sw = (struct libinput_event_switch *)event;
+		data->time_usec = sw->time;
+		data->u.switch_toggle.sw = sw->sw;
+		data->u.switch_toggle.state = sw->state;
+		break;
+	}
+
+	return 0;
+}
+
+/* The ABI rule in libinput.h relies on u being the last field */
+static_assert(offsetof(struct libinput_event_data, u) +
+	      sizeof(((struct libinput_event_data *)0)->u) ==
+	      sizeof(struct libinput_event_data),
+	      "libinput_event_data::u must be the last field");
+
+static inline bool
+event_data_size_is_valid(size_t size)
+{
+	return size >= offsetof(struct libinput_event_data, u);
+}
+
+LIBINPUT_EXPORT int
+libinput_event_get_data(struct libinput_event *event,
+			struct libinput_event_data *data)
+{
+	struct libinput_event_data full;
+	size_t size = data->size;
+
+	if (!event_data_size_is_valid(size))
+		return -1;
+
+	if (event_fill_data(event, &full) != 0)
+		return -1;
+
+	/* The caller's struct may be from an older or newer version of
+	 * libinput.h, copy only what both know about */
+	memcpy(data, &full, min(size, sizeof(full)));
+	if (size > sizeof(full))
+		memset((char *)data + sizeof(full), 0, size - sizeof(full));
+	data->size = size;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT size_t
+libinput_get_event_data_batch(struct libinput *libinput,
+			      struct libinput_event_data *data,
+			      size_t count)
+{
+	struct libinput_event *event;
+	struct libinput_event_data *d;
+	size_t size;
+	size_t n = 0;
+
+	if (count == 0)
+		return 0;
+
+	size = data->size;
+	if (!event_data_size_is_valid(size))
+		return 0;
+
+	while (n < count &&
+	       libinput->events_count > 0 &&
+	       libinput_next_event_type(libinput) !=
+			LIBINPUT_EVENT_DEVICE_REMOVED) {
+		d = (struct libinput_event_data *)((char *)data + n * size);
+		d->size = size;
+		event = libinput_get_event(libinput);
+		libinput_event_get_data(event, d);
+		libinput_event_destroy(event);
+		n++;
+	}
+
+	return n;
+}
+
 LIBINPUT_EXPORT void
 libinput_set_user_data(struct libinput *libinput,
 		       void *user_data)
@@ -3018,6 +3869,12 @@ libinput_device_touch_get_touch_count(struct libinput_device *device)
 	return evdev_device_get_touch_count((struct evdev_device *)device);
 }
 
+LIBINPUT_EXPORT int
+libinput_device_pointer_get_report_rate(struct libinput_device *device)
+{
+	return evdev_device_get_report_rate((struct evdev_device *)device);
+}
+
 LIBINPUT_EXPORT int
 libinput_device_switch_has_switch(struct libinput_device *device,
 				  enum libinput_switch sw)
@@ -3636,6 +4493,39 @@ libinput_device_config_tap_get_default_drag_lock_enabled(struct libinput_device
 	return device->config.tap->get_default_draglock_enabled(device);
 }
 
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_tap_set_adaptive_timeout_enabled(struct libinput_device *device,
+							enum libinput_config_tap_adaptive_timeout_state enable)
+{
+	if (enable != LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED &&
+	    enable != LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED)
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	if (libinput_device_config_tap_get_finger_count(device) == 0)
+		return enable ? LIBINPUT_CONFIG_STATUS_UNSUPPORTED :
+				LIBINPUT_CONFIG_STATUS_SUCCESS;
+
+	return device->config.tap->set_adaptive_timeout_enabled(device, enable);
+}
+
+LIBINPUT_EXPORT enum libinput_config_tap_adaptive_timeout_state
+libinput_device_config_tap_get_adaptive_timeout_enabled(struct libinput_device *device)
+{
+	if (libinput_device_config_tap_get_finger_count(device) == 0)
+		return LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED;
+
+	return device->config.tap->get_adaptive_timeout_enabled(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_tap_adaptive_timeout_state
+libinput_device_config_tap_get_default_adaptive_timeout_enabled(struct libinput_device *device)
+{
+	if (libinput_device_config_tap_get_finger_count(device) == 0)
+		return LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED;
+
+	return device->config.tap->get_default_adaptive_timeout_enabled(device);
+}
+
 LIBINPUT_EXPORT int
 libinput_device_config_calibration_has_matrix(struct libinput_device *device)
 {
@@ -3974,6 +4864,43 @@ libinput_device_config_middle_emulation_get_default_enabled(
 	return device->config.middle_emulation->get_default(device);
 }
 
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(
+		struct libinput_device *device,
+		enum libinput_config_middle_emulation_adaptive_timeout_state enable)
+{
+	if (enable != LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED &&
+	    enable != LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED)
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	if (!libinput_device_config_middle_emulation_is_available(device))
+		return enable ? LIBINPUT_CONFIG_STATUS_UNSUPPORTED :
+				LIBINPUT_CONFIG_STATUS_SUCCESS;
+
+	return device->config.middle_emulation->set_adaptive_timeout(device,
+								     enable);
+}
+
+LIBINPUT_EXPORT enum libinput_config_middle_emulation_adaptive_timeout_state
+libinput_device_config_middle_emulation_get_adaptive_timeout_enabled(
+		struct libinput_device *device)
+{
+	if (!libinput_device_config_middle_emulation_is_available(device))
+		return LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED;
+
+	return device->config.middle_emulation->get_adaptive_timeout(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_middle_emulation_adaptive_timeout_state
+libinput_device_config_middle_emulation_get_default_adaptive_timeout_enabled(
+		struct libinput_device *device)
+{
+	if (!libinput_device_config_middle_emulation_is_available(device))
+		return LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED;
+
+	return device->config.middle_emulation->get_default_adaptive_timeout(device);
+}
+
 LIBINPUT_EXPORT uint32_t
 libinput_device_config_scroll_get_methods(struct libinput_device *device)
 {
@@ -4141,3 +5068,74 @@ libinput_device_config_rotation_get_default_angle(struct libinput_device *device
 
 	return device->config.rotation->get_default_angle(device);
 }
+
+LIBINPUT_EXPORT int
+libinput_device_config_resample_is_available(struct libinput_device *device)
+{
+	if (!device->config.resample)
+		return 0;
+
+	return device->config.resample->is_available(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_resample_set_rate(struct libinput_device *device,
+					 unsigned int rate)
+{
+	if (!libinput_device_config_resample_is_available(device))
+		return rate ? LIBINPUT_CONFIG_STATUS_UNSUPPORTED :
+			      LIBINPUT_CONFIG_STATUS_SUCCESS;
+
+	if (rate > 1000)
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	return device->config.resample->set_rate(device, rate);
+}
+
+LIBINPUT_EXPORT unsigned int
+libinput_device_config_resample_get_rate(struct libinput_device *device)
+{
+	if (!libinput_device_config_resample_is_available(device))
+		return 0;
+
+	return device->config.resample->get_rate(device);
+}
+
+LIBINPUT_EXPORT unsigned int
+libinput_device_config_resample_get_default_rate(struct libinput_device *device)
+{
+	if (!libinput_device_config_resample_is_available(device))
+		return 0;
+
+	return device->config.resample->get_default_rate(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_tablet_tool_config_smoothing_set_method(struct libinput_tablet_tool *tool,
+						 enum libinput_config_tablet_tool_smoothing method)
+{
+	switch (method) {
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_NONE:
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE:
+	case LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE:
+		break;
+	default:
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+	}
+
+	tool->smoothing = method;
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+LIBINPUT_EXPORT enum libinput_config_tablet_tool_smoothing
+libinput_tablet_tool_config_smoothing_get_method(struct libinput_tablet_tool *tool)
+{
+	return tool->smoothing;
+}
+
+LIBINPUT_EXPORT enum libinput_config_tablet_tool_smoothing
+libinput_tablet_tool_config_smoothing_get_default_method(struct libinput_tablet_tool *tool)
+{
+	return LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE;
+}
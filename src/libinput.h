@@ -866,6 +866,34 @@ libinput_event_get_context(struct libinput_event *event);
 struct libinput_device *
 libinput_event_get_device(struct libinput_event *event);
 
+/**
+ * @ingroup event
+ *
+ * Return the id of the frame this event belongs to. All events generated
+ * from the same hardware frame, i.e. the same evdev SYN_REPORT, have the
+ * same frame id, regardless of their type. For example, a mouse that
+ * reports motion and a button press in the same hardware frame generates
+ * a @ref LIBINPUT_EVENT_POINTER_MOTION and a @ref
+ * LIBINPUT_EVENT_POINTER_BUTTON event with the same frame id. Events
+ * generated by a libinput-internal timeout, e.g. a tap, have a frame id
+ * of their own. Events generated outside of libinput_dispatch(), e.g. the
+ * button and key releases when a device is suspended or disabled, share a
+ * frame id with each other until the next call to libinput_dispatch() but
+ * never with events from a hardware frame.
+ *
+ * Events of one frame are always queued consecutively, a caller may
+ * thus accumulate the state changes of all events with the same frame id
+ * and apply them at once when an event with a different frame id is
+ * read. Frame ids increase monotonically but wrap around and are not
+ * consecutive, the caller must only compare them for equality. Device
+ * added and removed events always have a frame id of 0.
+ *
+ * @param event The libinput event
+ * @return The frame id of this event, or 0 for device notify events
+ */
+uint32_t
+libinput_event_get_frame_id(struct libinput_event *event);
+
 /**
  * @ingroup event
  *
@@ -1412,6 +1440,41 @@ double
 libinput_event_pointer_get_axis_value_discrete(struct libinput_event_pointer *event,
 					       enum libinput_pointer_axis axis);
 
+/**
+ * @ingroup event_pointer
+ *
+ * Return the scroll velocity on the given axis at the end of a scroll
+ * sequence, in the same units as libinput_event_pointer_get_axis_value()
+ * per second. The velocity is smoothed over the last few events of the
+ * scroll sequence and has natural scrolling applied already.
+ *
+ * The velocity is only set on the event terminating a scroll sequence,
+ * i.e. the event where libinput_event_pointer_get_axis_value() is 0, and
+ * only for the sources @ref LIBINPUT_POINTER_AXIS_SOURCE_FINGER and @ref
+ * LIBINPUT_POINTER_AXIS_SOURCE_CONTINUOUS. For all other events, this
+ * function returns 0.
+ *
+ * A velocity of 0 on the terminating event means the user stopped moving
+ * before ending the scroll sequence, e.g. the fingers rested on the
+ * touchpad before being lifted. A caller should not trigger kinetic
+ * scrolling in that case. Otherwise, a caller may use the velocity as the
+ * initial speed of kinetic scrolling instead of computing it from the
+ * preceding events.
+ *
+ * If the event does not have the given axis set, see
+ * libinput_event_pointer_has_axis(), this function returns 0.
+ *
+ * @note It is an application bug to call this function for events other than
+ * @ref LIBINPUT_EVENT_POINTER_AXIS.
+ *
+ * @return The scroll velocity on the given axis
+ *
+ * @see libinput_event_pointer_get_axis_value
+ */
+double
+libinput_event_pointer_get_axis_velocity(struct libinput_event_pointer *event,
+					 enum libinput_pointer_axis axis);
+
 /**
  * @ingroup event_pointer
  *
@@ -1574,6 +1637,63 @@ double
 libinput_event_touch_get_y_transformed(struct libinput_event_touch *event,
 				       uint32_t height);
 
+/**
+ * @ingroup event_touch
+ *
+ * Return the absolute x coordinate of the touch predicted for the given
+ * time, transformed to screen coordinates. The prediction uses the
+ * touch's recent motion and the method set with
+ * libinput_set_prediction_method(). If prediction is disabled, the motion
+ * history is insufficient or the time is not after the event time, this
+ * function returns the same value as
+ * libinput_event_touch_get_x_transformed(). Predictions are limited to
+ * a short time ahead of the event, later times are clamped.
+ *
+ * For events not of type @ref LIBINPUT_EVENT_TOUCH_DOWN, @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION, this function returns 0.
+ *
+ * @note It is an application bug to call this function for events of type
+ * other than @ref LIBINPUT_EVENT_TOUCH_DOWN or @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION.
+ *
+ * @param event The libinput touch event
+ * @param time_usec The time to predict the position for, in microseconds
+ * in the same clock as libinput_event_touch_get_time_usec()
+ * @param width The current output screen width
+ * @return The predicted absolute x coordinate transformed to a screen
+ * coordinate
+ */
+double
+libinput_event_touch_get_predicted_x_transformed(struct libinput_event_touch *event,
+						 uint64_t time_usec,
+						 uint32_t width);
+
+/**
+ * @ingroup event_touch
+ *
+ * Return the absolute y coordinate of the touch predicted for the given
+ * time, transformed to screen coordinates. See
+ * libinput_event_touch_get_predicted_x_transformed() for details.
+ *
+ * For events not of type @ref LIBINPUT_EVENT_TOUCH_DOWN, @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION, this function returns 0.
+ *
+ * @note It is an application bug to call this function for events of type
+ * other than @ref LIBINPUT_EVENT_TOUCH_DOWN or @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION.
+ *
+ * @param event The libinput touch event
+ * @param time_usec The time to predict the position for, in microseconds
+ * in the same clock as libinput_event_touch_get_time_usec()
+ * @param height The current output screen height
+ * @return The predicted absolute y coordinate transformed to a screen
+ * coordinate
+ */
+double
+libinput_event_touch_get_predicted_y_transformed(struct libinput_event_touch *event,
+						 uint64_t time_usec,
+						 uint32_t height);
+
 /**
  * @ingroup event_touch
  *
@@ -2241,6 +2361,49 @@ double
 libinput_event_tablet_tool_get_y_transformed(struct libinput_event_tablet_tool *event,
 					     uint32_t height);
 
+/**
+ * @ingroup event_tablet
+ *
+ * Return the absolute x coordinate of the tablet tool predicted for the
+ * given time, transformed to screen coordinates. The prediction uses the
+ * tool's recent motion and the method set with
+ * libinput_set_prediction_method(). If prediction is disabled, the motion
+ * history is insufficient or the time is not after the event time, this
+ * function returns the same value as
+ * libinput_event_tablet_tool_get_x_transformed(). Predictions are
+ * limited to a short time ahead of the event, later times are clamped.
+ *
+ * @param event The libinput tablet tool event
+ * @param time_usec The time to predict the position for, in microseconds
+ * in the same clock as libinput_event_tablet_tool_get_time_usec()
+ * @param width The current output screen width
+ * @return the predicted absolute x coordinate transformed to a screen
+ * coordinate
+ */
+double
+libinput_event_tablet_tool_get_predicted_x_transformed(struct libinput_event_tablet_tool *event,
+						       uint64_t time_usec,
+						       uint32_t width);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the absolute y coordinate of the tablet tool predicted for the
+ * given time, transformed to screen coordinates. See
+ * libinput_event_tablet_tool_get_predicted_x_transformed() for details.
+ *
+ * @param event The libinput tablet tool event
+ * @param time_usec The time to predict the position for, in microseconds
+ * in the same clock as libinput_event_tablet_tool_get_time_usec()
+ * @param height The current output screen height
+ * @return the predicted absolute y coordinate transformed to a screen
+ * coordinate
+ */
+double
+libinput_event_tablet_tool_get_predicted_y_transformed(struct libinput_event_tablet_tool *event,
+						       uint64_t time_usec,
+						       uint32_t height);
+
 /**
  * @ingroup event_tablet
  *
@@ -3081,6 +3244,339 @@ libinput_get_event(struct libinput *libinput);
 enum libinput_event_type
 libinput_next_event_type(struct libinput *libinput);
 
+/**
+ * @ingroup base
+ *
+ * Enable or disable events of the given type for this context. Events of
+ * a disabled type are discarded before they are created and never
+ * returned by libinput_get_event(). Where an entire feature only
+ * produces disabled event types, libinput may skip the feature's
+ * processing altogether, e.g. touchpad swipe and pinch detection is
+ * skipped if both the swipe and the pinch gesture events are disabled.
+ *
+ * The event types that make up a sequence are enabled or disabled
+ * together, so that a caller never sees only one half of a sequence.
+ * Setting any one of @ref LIBINPUT_EVENT_TOUCH_DOWN, @ref
+ * LIBINPUT_EVENT_TOUCH_UP, @ref LIBINPUT_EVENT_TOUCH_MOTION and @ref
+ * LIBINPUT_EVENT_TOUCH_CANCEL sets all four. Likewise, the begin, update
+ * and end types of the swipe gesture and of the pinch gesture are set
+ * together. @ref LIBINPUT_EVENT_TOUCH_FRAME can be set on its own.
+ * Other event types, e.g. @ref LIBINPUT_EVENT_POINTER_BUTTON, carry both
+ * halves of their sequence in one type.
+ *
+ * Disabling an event type does not affect libinput's internal state, for
+ * example the seat-wide key and button counts still reflect all key and
+ * button events.
+ *
+ * All event types are enabled by default. Events of type @ref
+ * LIBINPUT_EVENT_DEVICE_ADDED and @ref LIBINPUT_EVENT_DEVICE_REMOVED
+ * cannot be disabled.
+ *
+ * Changing the enabled state of an event type does not affect events
+ * already in the queue.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param type The event type to enable or disable
+ * @param enabled Non-zero to enable the event type, zero to disable it
+ *
+ * @return 0 on success or -1 if the event type is invalid or cannot be
+ * disabled
+ *
+ * @see libinput_get_event_type_enabled
+ */
+int
+libinput_set_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type,
+				int enabled);
+
+/**
+ * @ingroup base
+ *
+ * Check whether events of the given type are enabled for this context.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param type The event type to check
+ *
+ * @return 1 if the event type is enabled, 0 if it is disabled, -1 if
+ * the event type is invalid
+ *
+ * @see libinput_set_event_type_enabled
+ */
+int
+libinput_get_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type);
+
+/**
+ * @ingroup base
+ *
+ * The method used to extrapolate touch and tablet tool positions, see
+ * libinput_set_prediction_method().
+ */
+enum libinput_prediction_method {
+	/**
+	 * No prediction, the predicted position is the event position.
+	 */
+	LIBINPUT_PREDICTION_NONE = 0,
+	/**
+	 * Extrapolate with the velocity of the two most recent positions.
+	 */
+	LIBINPUT_PREDICTION_LINEAR,
+	/**
+	 * Extrapolate along a quadratic curve through the three most recent
+	 * positions, i.e. with velocity and acceleration.
+	 */
+	LIBINPUT_PREDICTION_QUADRATIC,
+};
+
+/**
+ * @ingroup base
+ *
+ * Set the method used to predict touch and tablet tool positions ahead
+ * of the event time, see libinput_event_touch_get_predicted_x_transformed()
+ * and libinput_event_tablet_tool_get_predicted_x_transformed(). A caller
+ * whose output lags behind the input, e.g. by one or more display frames,
+ * can use the predicted position for the next frame's presentation time
+ * to hide some of that latency.
+ *
+ * Prediction is disabled by default. libinput only keeps the motion
+ * history needed for prediction while a method other than @ref
+ * LIBINPUT_PREDICTION_NONE is set. Changing the method does not affect
+ * events already in the queue.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param method The prediction method
+ *
+ * @return 0 on success or -1 if the method is invalid
+ *
+ * @see libinput_get_prediction_method
+ */
+int
+libinput_set_prediction_method(struct libinput *libinput,
+			       enum libinput_prediction_method method);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return The prediction method currently in use
+ *
+ * @see libinput_set_prediction_method
+ */
+enum libinput_prediction_method
+libinput_get_prediction_method(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ * @struct libinput_event_data
+ *
+ * A plain copy of all data carried by a single event, filled in by
+ * libinput_event_get_data() or libinput_get_event_data_batch(). This
+ * allows a caller to read an event without calling the per-field
+ * accessor functions, e.g. for language bindings.
+ *
+ * The @ref type field selects which member of the @ref u union is valid.
+ * All fields not applicable to the event type are zero. Where the
+ * accessor function for a field is only permitted for some event types,
+ * the field is only filled in for those types. Coordinates are in mm,
+ * like those returned by libinput_event_touch_get_x() and friends, the
+ * transformed coordinates are not available.
+ *
+ * There is no pointer to the tablet tool or the tablet pad mode group.
+ * Use the tool's serial, tool ID and type to identify a tool.
+ *
+ * The caller must set the @ref size field to sizeof(struct
+ * libinput_event_data) before passing the struct to libinput, and
+ * libinput fills in no more than @ref size bytes. Where the caller's
+ * struct is larger than libinput's, the remainder is zeroed.
+ *
+ * The fields before @ref u are frozen as of libinput 1.12, the first
+ * version with this struct, and never change. @ref u is always the last
+ * field. Future versions of libinput only ever add fields at the end of
+ * a member of the @ref u union, growing the struct at its end. A caller
+ * built against an older version of this struct thus keeps working with
+ * a newer libinput, and vice versa.
+ */
+struct libinput_event_data {
+	/**
+	 * The size of this struct in bytes, set by the caller. libinput
+	 * does not modify this field.
+	 */
+	size_t size;
+	/** The event type, see libinput_event_get_type() */
+	enum libinput_event_type type;
+	/**
+	 * The device this event originated from. libinput does not take a
+	 * reference on behalf of the caller, see
+	 * libinput_get_event_data_batch() for the lifetime of this pointer.
+	 */
+	struct libinput_device *device;
+	/** The event time in microseconds, 0 for device notify events */
+	uint64_t time_usec;
+	/** The frame id, see libinput_event_get_frame_id() */
+	uint32_t frame_id;
+	/** The per-type event data */
+	union {
+		/** For @ref LIBINPUT_EVENT_KEYBOARD_KEY */
+		struct {
+			uint32_t key;
+			enum libinput_key_state state;
+			uint32_t seat_key_count;
+		} keyboard;
+		/** For all LIBINPUT_EVENT_POINTER_* events */
+		struct {
+			double dx;
+			double dy;
+			double dx_unaccelerated;
+			double dy_unaccelerated;
+			double absolute_x;
+			double absolute_y;
+			uint32_t button;
+			enum libinput_button_state state;
+			uint32_t seat_button_count;
+			enum libinput_pointer_axis_source axis_source;
+			/**
+			 * Bitmask of the axes set in this event, bit
+			 * (1 << axis) is set for each axis present
+			 */
+			uint32_t axes;
+			double scroll_vertical;
+			double scroll_horizontal;
+			double scroll_vertical_discrete;
+			double scroll_horizontal_discrete;
+			/** See libinput_event_pointer_get_axis_velocity() */
+			double scroll_vertical_velocity;
+			double scroll_horizontal_velocity;
+		} pointer;
+		/** For all LIBINPUT_EVENT_TOUCH_* events */
+		struct {
+			int32_t slot;
+			int32_t seat_slot;
+			double x;
+			double y;
+		} touch;
+		/** For all LIBINPUT_EVENT_GESTURE_* events */
+		struct {
+			int finger_count;
+			int cancelled;
+			double dx;
+			double dy;
+			double dx_unaccelerated;
+			double dy_unaccelerated;
+			double scale;
+			double angle_delta;
+		} gesture;
+		/** For all LIBINPUT_EVENT_TABLET_TOOL_* events */
+		struct {
+			enum libinput_tablet_tool_type tool_type;
+			uint64_t tool_serial;
+			uint64_t tool_id;
+			enum libinput_tablet_tool_proximity_state proximity_state;
+			enum libinput_tablet_tool_tip_state tip_state;
+			uint32_t button;
+			enum libinput_button_state button_state;
+			uint32_t seat_button_count;
+			/**
+			 * Bitmask of the axes that changed in this event,
+			 * bit (1 << n) is set if the value for the
+			 * equivalent libinput_event_tablet_tool_*_has_changed()
+			 * function is nonzero: x (bit 1), y (2), distance
+			 * (3), pressure (4), tilt x (5), tilt y (6),
+			 * rotation (7), slider (8), wheel (9).
+			 */
+			uint32_t changed;
+			double x;
+			double y;
+			double dx;
+			double dy;
+			double pressure;
+			double distance;
+			double tilt_x;
+			double tilt_y;
+			double rotation;
+			double slider;
+			double wheel_delta;
+			int wheel_delta_discrete;
+		} tablet_tool;
+		/** For all LIBINPUT_EVENT_TABLET_PAD_* events */
+		struct {
+			unsigned int mode;
+			uint32_t button;
+			enum libinput_button_state button_state;
+			unsigned int ring_number;
+			double ring_position;
+			enum libinput_tablet_pad_ring_axis_source ring_source;
+			unsigned int strip_number;
+			double strip_position;
+			enum libinput_tablet_pad_strip_axis_source strip_source;
+		} tablet_pad;
+		/** For @ref LIBINPUT_EVENT_SWITCH_TOGGLE */
+		struct {
+			enum libinput_switch sw;
+			enum libinput_switch_state state;
+		} switch_toggle;
+	} u;
+};
+
+/**
+ * @ingroup base
+ *
+ * Copy all data of the given event into the caller-provided struct. The
+ * event is not modified and must still be destroyed by the caller.
+ *
+ * This is equivalent to calling all accessor functions permitted for the
+ * event's type but avoids the per-call type checks.
+ *
+ * The size field of data must be set, see @ref libinput_event_data.
+ *
+ * @param event The event to copy
+ * @param data The struct to fill in
+ *
+ * @return 0 on success or -1 if the event is invalid or the size of data
+ * is too small to hold the fields preceding the @ref
+ * libinput_event_data::u union
+ *
+ * @see libinput_get_event_data_batch
+ */
+int
+libinput_event_get_data(struct libinput_event *event,
+			struct libinput_event_data *data);
+
+/**
+ * @ingroup base
+ *
+ * Retrieve up to count events from the event queue, copy their data into
+ * the caller-provided array and destroy the events. This is equivalent to
+ * calling libinput_get_event(), libinput_event_get_data() and
+ * libinput_event_destroy() for each event.
+ *
+ * This function stops before any event of type @ref
+ * LIBINPUT_EVENT_DEVICE_REMOVED, the caller must retrieve that event with
+ * libinput_get_event(). Thus, the device pointer in each struct filled in
+ * remains valid at least until the caller processes the next @ref
+ * LIBINPUT_EVENT_DEVICE_REMOVED event. If the first event in the queue is
+ * such an event, this function returns 0.
+ *
+ * The size field of the first element of data must be set, see @ref
+ * libinput_event_data. The array elements are that many bytes apart,
+ * libinput sets the size field of every element it fills in. If the size
+ * is too small to hold the fields preceding the @ref
+ * libinput_event_data::u union, this function returns 0 and leaves the
+ * queue untouched.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param data An array of at least count elements to fill in
+ * @param count The maximum number of events to retrieve
+ *
+ * @return The number of events copied into data
+ *
+ * @see libinput_event_get_data
+ * @see libinput_next_event_type
+ */
+size_t
+libinput_get_event_data_batch(struct libinput *libinput,
+			      struct libinput_event_data *data,
+			      size_t count);
+
 /**
  * @ingroup base
  *
@@ -3727,6 +4223,23 @@ libinput_device_keyboard_has_key(struct libinput_device *device,
 int
 libinput_device_touch_get_touch_count(struct libinput_device *device);
 
+/**
+ * @ingroup device
+ *
+ * Return the report rate of a @ref LIBINPUT_DEVICE_CAP_POINTER device in
+ * Hz. The report rate is not provided by the kernel, libinput estimates
+ * it from the timestamps of the device's motion events. Until the device
+ * has sent some motion events, the report rate is unknown.
+ *
+ * The estimate may change over the lifetime of the device.
+ *
+ * @param device A current input device
+ *
+ * @return The estimated report rate in Hz or 0 if unknown, -1 on error.
+ */
+int
+libinput_device_pointer_get_report_rate(struct libinput_device *device);
+
 /**
  * @ingroup device
  *
@@ -3872,6 +4385,8 @@ libinput_device_group_get_user_data(struct libinput_device_group *group);
  *    - libinput_device_config_tap_set_enabled()
  *    - libinput_device_config_tap_set_drag_enabled()
  *    - libinput_device_config_tap_set_drag_lock_enabled()
+ *    - libinput_device_config_tap_set_adaptive_timeout_enabled()
+ *    - libinput_device_config_middle_emulation_set_adaptive_timeout_enabled()
  *    - libinput_device_config_click_set_method()
  *    - libinput_device_config_scroll_set_method()
  *    - libinput_device_config_dwt_set_enabled()
@@ -4234,6 +4749,86 @@ libinput_device_config_tap_get_drag_lock_enabled(struct libinput_device *device)
 enum libinput_config_drag_lock_state
 libinput_device_config_tap_get_default_drag_lock_enabled(struct libinput_device *device);
 
+/**
+ * @ingroup config
+ */
+enum libinput_config_tap_adaptive_timeout_state {
+	/** The adaptive tap timeout is to be disabled, or is currently disabled */
+	LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED,
+	/** The adaptive tap timeout is to be enabled, or is currently enabled */
+	LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED,
+};
+
+/**
+ * @ingroup config
+ *
+ * Enable or disable the adaptive tap timeout on this device. With
+ * tap-and-drag enabled, the button release of a single tap is delayed
+ * by a timeout in case the tap is followed by a double-tap or a drag.
+ * When the adaptive timeout is enabled, libinput learns how quickly the
+ * user follows up a tap with another touch and shortens that timeout
+ * accordingly, reducing the delay of every single tap. See @ref tapndrag
+ * for details.
+ *
+ * Enabling the adaptive timeout on a device that has tapping or
+ * tap-and-drag disabled is permitted, but has no effect until both are
+ * enabled.
+ *
+ * @param device The device to configure
+ * @param enable @ref LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED to enable
+ * the adaptive timeout or @ref LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED
+ * to disable it
+ *
+ * @return A config status code. Disabling the adaptive timeout on a device
+ * that does not support tapping always succeeds.
+ *
+ * @see libinput_device_config_tap_get_adaptive_timeout_enabled
+ * @see libinput_device_config_tap_get_default_adaptive_timeout_enabled
+ */
+enum libinput_config_status
+libinput_device_config_tap_set_adaptive_timeout_enabled(struct libinput_device *device,
+							enum libinput_config_tap_adaptive_timeout_state enable);
+
+/**
+ * @ingroup config
+ *
+ * Check if the adaptive tap timeout is enabled on this device. If the
+ * device does not support tapping, this function always returns
+ * @ref LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED.
+ *
+ * @param device The device to configure
+ *
+ * @retval LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED If the adaptive
+ * timeout is currently enabled
+ * @retval LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED If the adaptive
+ * timeout is currently disabled
+ *
+ * @see libinput_device_config_tap_set_adaptive_timeout_enabled
+ * @see libinput_device_config_tap_get_default_adaptive_timeout_enabled
+ */
+enum libinput_config_tap_adaptive_timeout_state
+libinput_device_config_tap_get_adaptive_timeout_enabled(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Check if the adaptive tap timeout is enabled by default on this device.
+ * If the device does not support tapping, this function always returns
+ * @ref LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED.
+ *
+ * @param device The device to configure
+ *
+ * @retval LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED If the adaptive
+ * timeout is enabled by default
+ * @retval LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED If the adaptive
+ * timeout is disabled by default
+ *
+ * @see libinput_device_config_tap_set_adaptive_timeout_enabled
+ * @see libinput_device_config_tap_get_adaptive_timeout_enabled
+ */
+enum libinput_config_tap_adaptive_timeout_state
+libinput_device_config_tap_get_default_adaptive_timeout_enabled(struct libinput_device *device);
+
 /**
  * @ingroup config
  *
@@ -4995,6 +5590,96 @@ enum libinput_config_middle_emulation_state
 libinput_device_config_middle_emulation_get_default_enabled(
 		struct libinput_device *device);
 
+/**
+ * @ingroup config
+ */
+enum libinput_config_middle_emulation_adaptive_timeout_state {
+	/**
+	 * The adaptive middle button emulation timeout is to be disabled,
+	 * or is currently disabled.
+	 */
+	LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED,
+	/**
+	 * The adaptive middle button emulation timeout is to be enabled,
+	 * or is currently enabled.
+	 */
+	LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED,
+};
+
+/**
+ * @ingroup config
+ *
+ * Enable or disable the adaptive middle button emulation timeout on this
+ * device. With middle button emulation enabled, a left or right button
+ * press is delayed by a timeout in case the other button is pressed too.
+ * When the adaptive timeout is enabled, libinput learns how quickly the
+ * user presses the second button of a middle click and shortens that
+ * timeout accordingly, reducing the delay of every left and right click.
+ * See @ref middle_button_emulation for details.
+ *
+ * Enabling the adaptive timeout on a device that has middle button
+ * emulation disabled is permitted, but has no effect until middle button
+ * emulation is enabled.
+ *
+ * @param device The device to configure
+ * @param enable @ref
+ * LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED to enable the
+ * adaptive timeout or @ref
+ * LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED to disable it
+ *
+ * @return A config status code. Disabling the adaptive timeout on a device
+ * that does not support configurable middle button emulation always
+ * succeeds.
+ *
+ * @see libinput_device_config_middle_emulation_get_adaptive_timeout_enabled
+ * @see libinput_device_config_middle_emulation_get_default_adaptive_timeout_enabled
+ */
+enum libinput_config_status
+libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(
+		struct libinput_device *device,
+		enum libinput_config_middle_emulation_adaptive_timeout_state enable);
+
+/**
+ * @ingroup config
+ *
+ * Check if the adaptive middle button emulation timeout is enabled on this
+ * device. If the device does not have configurable middle button
+ * emulation, this function returns @ref
+ * LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED.
+ *
+ * @param device The device to configure
+ * @return @ref LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED
+ * if disabled or not available, @ref
+ * LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED if enabled.
+ *
+ * @see libinput_device_config_middle_emulation_set_adaptive_timeout_enabled
+ * @see libinput_device_config_middle_emulation_get_default_adaptive_timeout_enabled
+ */
+enum libinput_config_middle_emulation_adaptive_timeout_state
+libinput_device_config_middle_emulation_get_adaptive_timeout_enabled(
+		struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Check if the adaptive middle button emulation timeout is enabled by
+ * default on this device. If the device does not have configurable middle
+ * button emulation, this function returns @ref
+ * LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED.
+ *
+ * @param device The device to configure
+ * @return @ref LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED
+ * if disabled or not available by default, @ref
+ * LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED if enabled by
+ * default.
+ *
+ * @see libinput_device_config_middle_emulation_set_adaptive_timeout_enabled
+ * @see libinput_device_config_middle_emulation_get_adaptive_timeout_enabled
+ */
+enum libinput_config_middle_emulation_adaptive_timeout_state
+libinput_device_config_middle_emulation_get_default_adaptive_timeout_enabled(
+		struct libinput_device *device);
+
 /**
  * @ingroup config
  *
@@ -5372,6 +6057,153 @@ libinput_device_config_rotation_get_angle(struct libinput_device *device);
 unsigned int
 libinput_device_config_rotation_get_default_angle(struct libinput_device *device);
 
+/**
+ * @ingroup config
+ *
+ * Check whether a device can resample its pointer motion to a higher rate
+ * than the device's report rate. See @ref motion_resampling for details.
+ *
+ * @param device The device to check
+ * @return Non-zero if a device supports resampling, zero otherwise.
+ *
+ * @see libinput_device_config_resample_set_rate
+ * @see libinput_device_config_resample_get_rate
+ * @see libinput_device_config_resample_get_default_rate
+ */
+int
+libinput_device_config_resample_is_available(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Set the rate in Hz at which pointer motion is emitted. Where the device
+ * reports at a lower rate, the motion of each hardware event is split into
+ * several pointer motion events spread across the device's report
+ * interval. The total motion is unchanged, but parts of it are delayed by
+ * up to one report interval.
+ *
+ * A rate of 0 disables resampling. The rate must not exceed 1000Hz,
+ * otherwise this function returns LIBINPUT_CONFIG_STATUS_INVALID. A rate
+ * at or below the device's report rate has no effect.
+ *
+ * @param device The device to configure
+ * @param rate The pointer motion rate in Hz, or 0 to disable resampling
+ * @return A config status code. Disabling resampling on a device that
+ * does not support resampling always succeeds.
+ *
+ * @see libinput_device_config_resample_is_available
+ * @see libinput_device_config_resample_get_rate
+ * @see libinput_device_config_resample_get_default_rate
+ */
+enum libinput_config_status
+libinput_device_config_resample_set_rate(struct libinput_device *device,
+					 unsigned int rate);
+
+/**
+ * @ingroup config
+ *
+ * Get the current pointer motion resampling rate of a device in Hz. If
+ * this device does not support resampling, the return value is always 0.
+ *
+ * @param device The device to configure
+ * @return The resampling rate in Hz, or 0 if resampling is disabled
+ *
+ * @see libinput_device_config_resample_is_available
+ * @see libinput_device_config_resample_set_rate
+ * @see libinput_device_config_resample_get_default_rate
+ */
+unsigned int
+libinput_device_config_resample_get_rate(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Get the default pointer motion resampling rate of a device in Hz. If
+ * this device does not support resampling, the return value is always 0.
+ *
+ * @param device The device to configure
+ * @return The default resampling rate in Hz, or 0 if resampling is
+ * disabled by default
+ *
+ * @see libinput_device_config_resample_is_available
+ * @see libinput_device_config_resample_set_rate
+ * @see libinput_device_config_resample_get_rate
+ */
+unsigned int
+libinput_device_config_resample_get_default_rate(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * The smoothing method applied to the position and tilt of a tablet tool.
+ */
+enum libinput_config_tablet_tool_smoothing {
+	/**
+	 * No smoothing, the tool's position and tilt are passed on as
+	 * reported by the device.
+	 */
+	LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_NONE = 0,
+	/**
+	 * The position and tilt are averaged over the last few events.
+	 * This removes jitter but the smoothed position trails the tool
+	 * by a constant number of events.
+	 */
+	LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE,
+	/**
+	 * An adaptive low-pass filter smoothes the position and tilt.
+	 * Slow movements are smoothed heavily, fast movements have little
+	 * lag.
+	 */
+	LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE,
+};
+
+/**
+ * @ingroup config
+ *
+ * Set the smoothing method for this tool. The method applies to all
+ * events of this tool after the current event, on any device the tool is
+ * used with. See @ref tablet-smoothing for details.
+ *
+ * @param tool The libinput tool
+ * @param method The smoothing method to use
+ *
+ * @return A config status code
+ *
+ * @see libinput_tablet_tool_config_smoothing_get_method
+ * @see libinput_tablet_tool_config_smoothing_get_default_method
+ */
+enum libinput_config_status
+libinput_tablet_tool_config_smoothing_set_method(struct libinput_tablet_tool *tool,
+						 enum libinput_config_tablet_tool_smoothing method);
+
+/**
+ * @ingroup config
+ *
+ * Get the smoothing method for this tool.
+ *
+ * @param tool The libinput tool
+ * @return The smoothing method currently in use for this tool
+ *
+ * @see libinput_tablet_tool_config_smoothing_set_method
+ * @see libinput_tablet_tool_config_smoothing_get_default_method
+ */
+enum libinput_config_tablet_tool_smoothing
+libinput_tablet_tool_config_smoothing_get_method(struct libinput_tablet_tool *tool);
+
+/**
+ * @ingroup config
+ *
+ * Get the default smoothing method for this tool.
+ *
+ * @param tool The libinput tool
+ * @return The default smoothing method for this tool
+ *
+ * @see libinput_tablet_tool_config_smoothing_set_method
+ * @see libinput_tablet_tool_config_smoothing_get_method
+ */
+enum libinput_config_tablet_tool_smoothing
+libinput_tablet_tool_config_smoothing_get_default_method(struct libinput_tablet_tool *tool);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,88 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef REPORT_RATE_H
+#define REPORT_RATE_H
+
+#include "config.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libinput-util.h"
+
+/* Anything longer is a pause in the motion, not the device's report
+ * interval */
+#define REPORT_RATE_MAX_INTERVAL ms2us(50)
+
+/* A device's report rate, estimated from the timestamps of its motion
+ * frames */
+struct report_rate {
+	uint64_t last_time;
+	double interval;	/* us, smoothed */
+	unsigned int rate;	/* Hz, 0 if unknown */
+};
+
+/**
+ * Update the estimate with the timestamp of a motion frame.
+ *
+ * @return true if the estimate was updated, false if the interval since
+ * the previous frame was discarded
+ */
+static inline bool
+report_rate_update(struct report_rate *rr, uint64_t time)
+{
+	uint64_t last_time = rr->last_time;
+	uint64_t interval;
+	double smoothed;
+
+	rr->last_time = time;
+
+	if (last_time == 0 || time <= last_time)
+		return false;
+
+	interval = time - last_time;
+	if (interval > REPORT_RATE_MAX_INTERVAL)
+		return false;
+
+	/* Devices only send events while there is motion, so slow
+	 * movements give us intervals longer than the actual report
+	 * interval. Converge quickly towards shorter intervals and only
+	 * slowly towards longer ones. */
+	smoothed = rr->interval;
+	if (smoothed == 0.0)
+		smoothed = interval;
+	else if (interval < smoothed)
+		smoothed = (smoothed * 3 + interval) / 4;
+	else
+		smoothed = (smoothed * 63 + interval) / 64;
+
+	rr->interval = smoothed;
+	rr->rate = round(s2us(1) / smoothed);
+
+	return true;
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <unistd.h>
 
 #include "libinput-private.h"
+#include "libinput-trace.h"
 #include "timer.h"
 
 void
@@ -60,9 +61,12 @@ libinput_timer_arm_timer_fd(struct libinput *libinput)
 	struct itimerspec its = { { 0, 0 }, { 0, 0 } };
 	uint64_t earliest_expire = UINT64_MAX;
 
+	/* A timer must expire between its expiry time and the end of its
+	 * slack window. Waking up at the earliest window end covers that
+	 * and handles every other timer already expired at that time */
 	list_for_each(timer, &libinput->timer.list, link) {
-		if (timer->expire < earliest_expire)
-			earliest_expire = timer->expire;
+		if (timer->expire + timer->slack < earliest_expire)
+			earliest_expire = timer->expire + timer->slack;
 	}
 
 	if (earliest_expire != UINT64_MAX) {
@@ -100,10 +104,13 @@ libinput_timer_set_flags(struct libinput_timer *timer,
 
 	assert(expire);
 
+	libinput_trace3(timer_set, timer->timer_name, expire, flags);
+
 	if (!timer->expire)
 		list_insert(&timer->libinput->timer.list, &timer->link);
 
 	timer->expire = expire;
+	timer->slack = (flags & TIMER_FLAG_COARSE) ? TIMER_COARSE_SLACK : 0;
 	libinput_timer_arm_timer_fd(timer->libinput);
 }
 
@@ -137,8 +144,16 @@ restart:
 		if (timer->expire <= now) {
 			/* Clear the timer before calling timer_func,
 			   as timer_func may re-arm it */
+			libinput_trace3(timer_fire,
+					timer->timer_name,
+					timer->expire,
+					now);
 			libinput_timer_cancel(timer);
+			/* a timer may expire while a device frame is being
+			 * processed, its events get a frame of their own */
+			libinput_end_frame(libinput);
 			timer->timer_func(now, timer->timer_func_data);
+			libinput_end_frame(libinput);
 
 			/*
 			 * Restart the loop. We can't use
@@ -172,6 +187,16 @@ libinput_timer_dispatch(void *data)
 	if (now == 0)
 		return;
 
+	libinput->timer.wakeups++;
+	if (now - libinput->timer.wakeups_start >= s2us(1)) {
+		log_debug(libinput,
+			  "timer: %u wakeups in %ums\n",
+			  libinput->timer.wakeups,
+			  (unsigned int)us2ms(now - libinput->timer.wakeups_start));
+		libinput->timer.wakeups = 0;
+		libinput->timer.wakeups_start = now;
+	}
+
 	libinput_timer_handler(libinput, now);
 }
 
@@ -184,6 +209,7 @@ libinput_timer_subsys_init(struct libinput *libinput)
 		return -1;
 
 	list_init(&libinput->timer.list);
+	libinput->timer.wakeups_start = libinput_now(libinput);
 
 	libinput->timer.source = libinput_add_fd(libinput,
 						 libinput->timer.fd,
@@ -35,6 +35,7 @@ struct libinput_timer {
 	char *timer_name;
 	struct list link;
 	uint64_t expire; /* in absolute us CLOCK_MONOTONIC */
+	uint64_t slack; /* in us, how late the timer may expire */
 	void (*timer_func)(uint64_t now, void *timer_func_data);
 	void *timer_func_data;
 };
@@ -52,9 +53,15 @@ libinput_timer_destroy(struct libinput_timer *timer);
 void
 libinput_timer_set(struct libinput_timer *timer, uint64_t expire);
 
+/* Maximum delay of a timer set with TIMER_FLAG_COARSE */
+#define TIMER_COARSE_SLACK ms2us(20)
+
 enum timer_flags {
 	TIMER_FLAG_NONE = 0,
 	TIMER_FLAG_ALLOW_NEGATIVE = (1 << 0),
+	/* The timer may expire up to TIMER_COARSE_SLACK late, so it can
+	 * share a wakeup with another timer */
+	TIMER_FLAG_COARSE = (1 << 1),
 };
 
 void
@@ -0,0 +1,153 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "evdev-fallback.h"
+
+/* Compares the per-frame cost of finding the changed buttons with
+ * hw_key_get_changed() against the per-code loop it replaced. This is a
+ * benchmark only, run it with meson test --benchmark */
+
+#define NFRAMES 200000
+
+static uint64_t
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The loop fallback_handle_state() used before hw_key_get_changed() */
+static size_t
+get_changed_per_code(struct fallback_dispatch *dispatch,
+		     unsigned int *codes,
+		     size_t max)
+{
+	size_t nchanged = 0;
+
+	for (unsigned int code = 0; code <= KEY_MAX; code++) {
+		if (long_bit_is_set(dispatch->hw_key_mask, code) ==
+		    long_bit_is_set(dispatch->last_hw_key_mask, code))
+			continue;
+
+		if (get_key_type(code) != KEY_TYPE_BUTTON)
+			continue;
+
+		if (nchanged == max)
+			break;
+		codes[nchanged++] = code;
+	}
+
+	return nchanged;
+}
+
+static void
+run(const char *name,
+    struct fallback_dispatch *dispatch,
+    const unsigned int *frames,
+    size_t nframes)
+{
+	unsigned int codes[128];
+	uint64_t start, loop_ns, mask_ns;
+	size_t loop_total = 0, mask_total = 0;
+
+	memset(dispatch->hw_key_mask, 0, sizeof(dispatch->hw_key_mask));
+	memset(dispatch->last_hw_key_mask, 0, sizeof(dispatch->last_hw_key_mask));
+	start = now_ns();
+	for (size_t i = 0; i < nframes; i++) {
+		long_set_bit_state(dispatch->hw_key_mask, frames[i], i % 2 == 0);
+		loop_total += get_changed_per_code(dispatch,
+						   codes,
+						   ARRAY_LENGTH(codes));
+		memcpy(dispatch->last_hw_key_mask,
+		       dispatch->hw_key_mask,
+		       sizeof(dispatch->hw_key_mask));
+	}
+	loop_ns = now_ns() - start;
+
+	memset(dispatch->hw_key_mask, 0, sizeof(dispatch->hw_key_mask));
+	memset(dispatch->last_hw_key_mask, 0, sizeof(dispatch->last_hw_key_mask));
+	start = now_ns();
+	for (size_t i = 0; i < nframes; i++) {
+		long_set_bit_state(dispatch->hw_key_mask, frames[i], i % 2 == 0);
+		mask_total += hw_key_get_changed(dispatch,
+						 dispatch->button_mask,
+						 codes,
+						 ARRAY_LENGTH(codes));
+		memcpy(dispatch->last_hw_key_mask,
+		       dispatch->hw_key_mask,
+		       sizeof(dispatch->hw_key_mask));
+	}
+	mask_ns = now_ns() - start;
+
+	if (loop_total != mask_total) {
+		fprintf(stderr,
+			"%s: %zu changes per code, %zu per long\n",
+			name, loop_total, mask_total);
+		exit(1);
+	}
+
+	printf("%-10s per code: %6.1fns/frame, per long: %6.1fns/frame\n",
+	       name,
+	       (double)loop_ns / nframes,
+	       (double)mask_ns / nframes);
+}
+
+int
+main(void)
+{
+	struct fallback_dispatch *dispatch;
+	unsigned int *frames;
+
+	dispatch = zalloc(sizeof(*dispatch));
+	for (unsigned int code = 0; code <= KEY_MAX; code++) {
+		if (get_key_type(code) == KEY_TYPE_BUTTON)
+			long_set_bit(dispatch->button_mask, code);
+	}
+
+	/* Every frame presses or releases one key, alternating, the way
+	 * a keyboard or a mouse sends them */
+	frames = zalloc(NFRAMES * sizeof(*frames));
+
+	srand(1);
+	for (size_t i = 0; i < NFRAMES; i += 2)
+		frames[i] = frames[i + 1] = KEY_ESC + rand() % (KEY_MICMUTE - KEY_ESC);
+	run("keyboard", dispatch, frames, NFRAMES);
+
+	for (size_t i = 0; i < NFRAMES; i += 2)
+		frames[i] = frames[i + 1] = BTN_LEFT + rand() % (BTN_TASK - BTN_LEFT);
+	run("mouse", dispatch, frames, NFRAMES);
+
+	free(frames);
+	free(dispatch);
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <assert.h>
+
+#include "litest.h"
+#include "litest-int.h"
+
+/* Protocol A with ABS_MT_TRACKING_ID: every contact carries its
+ * tracking ID in every frame. The litest slot number identifies the
+ * contact, a new ID is assigned on each touch down. */
+static int tracking_ids[10];
+static int next_tracking_id;
+
+static void
+send_contact(struct litest_device *d, unsigned int slot, double x, double y)
+{
+	assert(slot < ARRAY_LENGTH(tracking_ids));
+
+	litest_event(d, EV_ABS, ABS_X, litest_scale(d, ABS_X, x));
+	litest_event(d, EV_ABS, ABS_Y, litest_scale(d, ABS_Y, y));
+	litest_event(d, EV_ABS, ABS_MT_TRACKING_ID, tracking_ids[slot]);
+	litest_event(d, EV_ABS, ABS_MT_POSITION_X, litest_scale(d, ABS_X, x));
+	litest_event(d, EV_ABS, ABS_MT_POSITION_Y, litest_scale(d, ABS_Y, y));
+	litest_event(d, EV_SYN, SYN_MT_REPORT, 0);
+	litest_event(d, EV_KEY, BTN_TOUCH, 1);
+	litest_event(d, EV_SYN, SYN_REPORT, 0);
+}
+
+static void
+touch_down(struct litest_device *d, unsigned int slot, double x, double y)
+{
+	assert(slot < ARRAY_LENGTH(tracking_ids));
+
+	tracking_ids[slot] = ++next_tracking_id;
+	send_contact(d, slot, x, y);
+}
+
+static void
+touch_move(struct litest_device *d, unsigned int slot, double x, double y)
+{
+	send_contact(d, slot, x, y);
+}
+
+static void
+touch_up(struct litest_device *d, unsigned int slot)
+{
+	assert(slot < ARRAY_LENGTH(tracking_ids));
+
+	tracking_ids[slot] = -1;
+	litest_event(d, EV_SYN, SYN_MT_REPORT, 0);
+	litest_event(d, EV_KEY, BTN_TOUCH, d->ntouches_down > 0);
+	litest_event(d, EV_SYN, SYN_REPORT, 0);
+}
+
+static struct litest_device_interface interface = {
+	.touch_down = touch_down,
+	.touch_move = touch_move,
+	.touch_up = touch_up,
+};
+
+static struct input_absinfo absinfo[] = {
+	{ ABS_X, 0, 32767, 0, 0, 0 },
+	{ ABS_Y, 0, 32767, 0, 0, 0 },
+	{ ABS_MT_POSITION_X, 0, 32767, 0, 0, 0 },
+	{ ABS_MT_POSITION_Y, 0, 32767, 0, 0, 0 },
+	{ ABS_MT_TRACKING_ID, 0, 65535, 0, 0, 0 },
+	{ .value = -1 },
+};
+
+static struct input_id input_id = {
+	.bustype = 0x18,
+	.vendor = 0xeef,
+	.product = 0x21,
+};
+
+static int events[] = {
+	EV_KEY, BTN_TOUCH,
+	INPUT_PROP_MAX, INPUT_PROP_DIRECT,
+	-1, -1,
+};
+
+TEST_DEVICE("protocol-a-tracking-id",
+	.type = LITEST_PROTOCOL_A_SCREEN_TRACKING_ID,
+	.features = LITEST_PROTOCOL_A,
+	.interface = &interface,
+
+	.name = "Protocol A touch screen with tracking ID",
+	.id = &input_id,
+	.events = events,
+	.absinfo = absinfo,
+)
@@ -3554,13 +3554,13 @@ litest_timeout_middlebutton(void)
 void
 litest_timeout_dwt_short(void)
 {
-	msleep(220);
+	msleep(240);
 }
 
 void
 litest_timeout_dwt_long(void)
 {
-	msleep(520);
+	msleep(540);
 }
 
 void
@@ -3578,7 +3578,7 @@ litest_timeout_gesture_scroll(void)
 void
 litest_timeout_trackpoint(void)
 {
-	msleep(320);
+	msleep(340);
 }
 
 void
@@ -288,6 +288,7 @@ enum litest_device_type {
 	LITEST_MS_NANO_TRANSCEIVER_MOUSE,
 	LITEST_AIPTEK,
 	LITEST_TOUCHSCREEN_INVALID_RANGE,
+	LITEST_PROTOCOL_A_SCREEN_TRACKING_ID,
 };
 
 enum litest_device_feature {
@@ -156,6 +156,86 @@ START_TEST(gestures_swipe_3fg)
 }
 END_TEST
 
+START_TEST(gestures_swipe_3fg_disabled)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	enum libinput_event_type type;
+
+	if (libevdev_get_num_slots(dev->evdev) < 3)
+		return;
+
+	/* Disabling the begin type disables the whole swipe sequence,
+	 * pinch stays enabled so gesture detection still runs */
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN,
+					 0),
+			 0);
+
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 40, 40);
+	litest_touch_down(dev, 1, 50, 40);
+	litest_touch_down(dev, 2, 60, 40);
+	libinput_dispatch(li);
+	litest_touch_move_three_touches(dev,
+					40, 40,
+					50, 40,
+					60, 40,
+					0, 30,
+					10, 2);
+	litest_touch_up(dev, 0);
+	litest_touch_up(dev, 1);
+	litest_touch_up(dev, 2);
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		type = libinput_event_get_type(event);
+		ck_assert(type < LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN ||
+			  type > LIBINPUT_EVENT_GESTURE_SWIPE_END);
+		libinput_event_destroy(event);
+	}
+
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_GESTURE_SWIPE_END,
+					 1),
+			 0);
+
+	litest_touch_down(dev, 0, 40, 40);
+	litest_touch_down(dev, 1, 50, 40);
+	litest_touch_down(dev, 2, 60, 40);
+	libinput_dispatch(li);
+	litest_touch_move_three_touches(dev,
+					40, 40,
+					50, 40,
+					60, 40,
+					0, 30,
+					10, 2);
+	litest_touch_up(dev, 0);
+	litest_touch_up(dev, 1);
+	litest_touch_up(dev, 2);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_gesture_event(event,
+				LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN,
+				3);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	while (event &&
+	       libinput_event_get_type(event) ==
+	       LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE) {
+		libinput_event_destroy(event);
+		event = libinput_get_event(li);
+	}
+	litest_is_gesture_event(event,
+				LIBINPUT_EVENT_GESTURE_SWIPE_END,
+				3);
+	libinput_event_destroy(event);
+}
+END_TEST
+
 START_TEST(gestures_swipe_3fg_btntool)
 {
 	struct litest_device *dev = litest_current_device();
@@ -1068,6 +1148,7 @@ TEST_COLLECTION(gestures)
 
 	litest_add_ranged("gestures:swipe", gestures_swipe_3fg, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH, &cardinals);
 	litest_add_ranged("gestures:swipe", gestures_swipe_3fg_btntool, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH, &cardinals);
+	litest_add("gestures:swipe", gestures_swipe_3fg_disabled, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH);
 	litest_add_ranged("gestures:swipe", gestures_swipe_4fg, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH, &cardinals);
 	litest_add_ranged("gestures:swipe", gestures_swipe_4fg_btntool, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH, &cardinals);
 	litest_add_ranged("gestures:pinch", gestures_pinch, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH, &cardinals);
@@ -33,6 +33,8 @@
 
 #include "litest.h"
 #include "libinput-util.h"
+#include "adaptive-timeout.h"
+#include "report-rate.h"
 #define  TEST_VERSIONSORT
 #include "libinput-versionsort.h"
 
@@ -126,6 +128,7 @@ START_TEST(event_conversion_device_notify)
 			dn = libinput_event_get_device_notify_event(event);
 			base = libinput_event_device_notify_get_base_event(dn);
 			ck_assert(event == base);
+			ck_assert_int_eq(libinput_event_get_frame_id(event), 0);
 
 			if (type == LIBINPUT_EVENT_DEVICE_ADDED)
 				device_added++;
@@ -543,6 +546,263 @@ START_TEST(event_conversion_switch)
 }
 END_TEST
 
+START_TEST(event_data_pointer)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *p;
+	struct libinput_event_data data;
+
+	litest_drain_events(li);
+
+	litest_event(dev, EV_REL, REL_X, -1);
+	litest_event(dev, EV_REL, REL_Y, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_button_click_debounced(dev, li, BTN_LEFT, 1);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	p = litest_is_motion_event(event);
+	data.size = sizeof(data);
+	ck_assert_int_eq(libinput_event_get_data(event, &data), 0);
+	ck_assert_int_eq(data.size, sizeof(data));
+	ck_assert_int_eq(data.type, LIBINPUT_EVENT_POINTER_MOTION);
+	ck_assert(data.device == dev->libinput_device);
+	ck_assert_int_eq(data.time_usec,
+			 libinput_event_pointer_get_time_usec(p));
+	ck_assert_double_eq(data.u.pointer.dx,
+			    libinput_event_pointer_get_dx(p));
+	ck_assert_double_eq(data.u.pointer.dy,
+			    libinput_event_pointer_get_dy(p));
+	ck_assert_double_eq(data.u.pointer.dx_unaccelerated, -1.0);
+	ck_assert_double_eq(data.u.pointer.dy_unaccelerated, 1.0);
+	libinput_event_destroy(event);
+
+	event = libinput_get_event(li);
+	litest_is_button_event(event,
+			       BTN_LEFT,
+			       LIBINPUT_BUTTON_STATE_PRESSED);
+	ck_assert_int_eq(libinput_event_get_data(event, &data), 0);
+	ck_assert_int_eq(data.type, LIBINPUT_EVENT_POINTER_BUTTON);
+	ck_assert_int_eq(data.u.pointer.button, BTN_LEFT);
+	ck_assert_int_eq(data.u.pointer.state, LIBINPUT_BUTTON_STATE_PRESSED);
+	ck_assert_int_eq(data.u.pointer.seat_button_count, 1);
+	ck_assert_double_eq(data.u.pointer.dx, 0.0);
+	libinput_event_destroy(event);
+
+	litest_button_click_debounced(dev, li, BTN_LEFT, 0);
+}
+END_TEST
+
+START_TEST(event_data_size)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_data data;
+
+	litest_drain_events(li);
+
+	litest_event(dev, EV_REL, REL_X, -1);
+	litest_event(dev, EV_REL, REL_Y, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_motion_event(event);
+
+	data.size = 0;
+	ck_assert_int_eq(libinput_event_get_data(event, &data), -1);
+	data.size = offsetof(struct libinput_event_data, u) - 1;
+	ck_assert_int_eq(libinput_event_get_data(event, &data), -1);
+
+	/* A caller with an older, smaller struct only gets what fits */
+	memset(&data, 0xab, sizeof(data));
+	data.size = offsetof(struct libinput_event_data, u);
+	ck_assert_int_eq(libinput_event_get_data(event, &data), 0);
+	ck_assert_int_eq(data.size, offsetof(struct libinput_event_data, u));
+	ck_assert_int_eq(data.type, LIBINPUT_EVENT_POINTER_MOTION);
+	ck_assert(data.device == dev->libinput_device);
+	ck_assert_int_eq(*(unsigned char *)&data.u, 0xab);
+	libinput_event_destroy(event);
+
+	litest_event(dev, EV_REL, REL_X, -1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	/* An invalid size leaves the queue untouched */
+	data.size = 0;
+	ck_assert_int_eq(libinput_get_event_data_batch(li, &data, 1), 0);
+	ck_assert_int_eq(libinput_next_event_type(li),
+			 LIBINPUT_EVENT_POINTER_MOTION);
+	litest_drain_events(li);
+}
+END_TEST
+
+START_TEST(event_frame_id)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	uint32_t frame;
+
+	litest_drain_events(li);
+
+	litest_event(dev, EV_REL, REL_X, -1);
+	litest_event(dev, EV_REL, REL_Y, 1);
+	litest_event(dev, EV_KEY, BTN_LEFT, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_motion_event(event);
+	frame = libinput_event_get_frame_id(event);
+	ck_assert_int_ne(frame, 0);
+	libinput_event_destroy(event);
+
+	event = libinput_get_event(li);
+	litest_is_button_event(event,
+			       BTN_LEFT,
+			       LIBINPUT_BUTTON_STATE_PRESSED);
+	ck_assert_int_eq(libinput_event_get_frame_id(event), frame);
+	libinput_event_destroy(event);
+
+	litest_event(dev, EV_REL, REL_X, -1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_motion_event(event);
+	ck_assert_int_ne(libinput_event_get_frame_id(event), frame);
+	ck_assert_int_ne(libinput_event_get_frame_id(event), 0);
+	libinput_event_destroy(event);
+
+	litest_button_click_debounced(dev, li, BTN_LEFT, 0);
+}
+END_TEST
+
+START_TEST(event_frame_id_suspend)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput_event *event;
+	uint32_t frame;
+
+	litest_drain_events(li);
+
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_drain_events(li);
+
+	/* the release is posted outside of any hardware frame */
+	libinput_device_config_send_events_set_mode(device,
+			LIBINPUT_CONFIG_SEND_EVENTS_DISABLED);
+	libinput_device_config_send_events_set_mode(device,
+			LIBINPUT_CONFIG_SEND_EVENTS_ENABLED);
+
+	litest_keyboard_key(dev, KEY_B, true);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_keyboard_event(event,
+				 KEY_A,
+				 LIBINPUT_KEY_STATE_RELEASED);
+	frame = libinput_event_get_frame_id(event);
+	ck_assert_int_ne(frame, 0);
+	libinput_event_destroy(event);
+
+	event = libinput_get_event(li);
+	litest_is_keyboard_event(event,
+				 KEY_B,
+				 LIBINPUT_KEY_STATE_PRESSED);
+	ck_assert_int_ne(libinput_event_get_frame_id(event), frame);
+	ck_assert_int_ne(libinput_event_get_frame_id(event), 0);
+	libinput_event_destroy(event);
+
+	litest_keyboard_key(dev, KEY_B, false);
+	litest_keyboard_key(dev, KEY_A, false);
+	litest_drain_events(li);
+}
+END_TEST
+
+START_TEST(event_data_batch)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event_data data[4];
+	size_t n;
+
+	litest_drain_events(li);
+
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	litest_keyboard_key(dev, KEY_B, true);
+	litest_keyboard_key(dev, KEY_B, false);
+	libinput_dispatch(li);
+
+	data[0].size = sizeof(data[0]);
+	n = libinput_get_event_data_batch(li, data, 3);
+	ck_assert_int_eq(data[2].size, sizeof(data[2]));
+	ck_assert_int_eq(n, 3);
+	ck_assert_int_eq(data[0].type, LIBINPUT_EVENT_KEYBOARD_KEY);
+	ck_assert_int_eq(data[0].u.keyboard.key, KEY_A);
+	ck_assert_int_eq(data[0].u.keyboard.state, LIBINPUT_KEY_STATE_PRESSED);
+	ck_assert_int_eq(data[0].u.keyboard.seat_key_count, 1);
+	ck_assert_int_eq(data[1].u.keyboard.key, KEY_A);
+	ck_assert_int_eq(data[1].u.keyboard.state, LIBINPUT_KEY_STATE_RELEASED);
+	ck_assert_int_eq(data[2].u.keyboard.key, KEY_B);
+	ck_assert(data[0].device == dev->libinput_device);
+	ck_assert_int_le(data[0].time_usec, data[2].time_usec);
+
+	n = libinput_get_event_data_batch(li, data, ARRAY_LENGTH(data));
+	ck_assert_int_eq(n, 1);
+	ck_assert_int_eq(data[0].u.keyboard.key, KEY_B);
+	ck_assert_int_eq(data[0].u.keyboard.state, LIBINPUT_KEY_STATE_RELEASED);
+
+	n = libinput_get_event_data_batch(li, data, ARRAY_LENGTH(data));
+	ck_assert_int_eq(n, 0);
+}
+END_TEST
+
+START_TEST(event_data_batch_device_removed)
+{
+	struct libinput *li;
+	struct litest_device *dev;
+	struct libinput_event_data data[4];
+	struct libinput_event *event;
+	size_t n;
+
+	li = litest_create_context();
+	dev = litest_add_device(li, LITEST_KEYBOARD);
+	litest_drain_events(li);
+
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+	libinput_path_remove_device(dev->libinput_device);
+	libinput_dispatch(li);
+
+	/* The batch must stop before the device removed event */
+	data[0].size = sizeof(data[0]);
+	n = libinput_get_event_data_batch(li, data, ARRAY_LENGTH(data));
+	ck_assert_int_eq(n, 2);
+	ck_assert_int_eq(libinput_next_event_type(li),
+			 LIBINPUT_EVENT_DEVICE_REMOVED);
+	n = libinput_get_event_data_batch(li, data, ARRAY_LENGTH(data));
+	ck_assert_int_eq(n, 0);
+
+	event = libinput_get_event(li);
+	ck_assert_int_eq(libinput_event_get_data(event, &data[0]), 0);
+	ck_assert_int_eq(data[0].type, LIBINPUT_EVENT_DEVICE_REMOVED);
+	ck_assert_int_eq(data[0].time_usec, 0);
+	libinput_event_destroy(event);
+
+	libinput_unref(li);
+	litest_delete_device(dev);
+}
+END_TEST
+
 START_TEST(bitfield_helpers)
 {
 	/* This value has a bit set on all of the word boundaries we want to
@@ -737,6 +997,104 @@ START_TEST(ratelimit_helpers)
 }
 END_TEST
 
+START_TEST(report_rate_helpers)
+{
+	struct report_rate rr = {0};
+	uint64_t time = s2us(1);
+	int i;
+
+	/* the first frame has no interval */
+	ck_assert(!report_rate_update(&rr, time));
+	ck_assert_int_eq(rr.rate, 0);
+
+	/* a 125Hz mouse */
+	for (i = 0; i < 10; i++) {
+		time += ms2us(8);
+		ck_assert(report_rate_update(&rr, time));
+		ck_assert_int_eq(rr.rate, 125);
+	}
+
+	/* a pause in the motion is not an interval */
+	time += ms2us(500);
+	ck_assert(!report_rate_update(&rr, time));
+	ck_assert_int_eq(rr.rate, 125);
+
+	/* neither is a timestamp going backwards */
+	ck_assert(!report_rate_update(&rr, time - 1));
+	ck_assert_int_eq(rr.rate, 125);
+
+	/* shorter intervals win quickly... */
+	time = rr.last_time;
+	for (i = 0; i < 20; i++) {
+		time += ms2us(1);
+		ck_assert(report_rate_update(&rr, time));
+	}
+	ck_assert_int_eq(rr.rate, 978);
+
+	/* ..longer ones from slow motion only slowly */
+	time += ms2us(20);
+	ck_assert(report_rate_update(&rr, time));
+	ck_assert_int_eq(rr.rate, 758);
+}
+END_TEST
+
+START_TEST(adaptive_timeout_helpers)
+{
+	struct adaptive_timeout at;
+	uint64_t time = s2us(1);
+	int i;
+
+	/* the tapping configuration */
+	adaptive_timeout_init(&at, ms2us(100), ms2us(180), ms2us(30), 8);
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(180));
+
+	/* disabled, an expired timeout is never a miss */
+	adaptive_timeout_expired(&at, time);
+	ck_assert(!adaptive_timeout_check_expired(&at, time + ms2us(50)));
+
+	at.enabled = true;
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(180));
+
+	/* nothing is learned before min_samples gaps */
+	for (i = 0; i < 7; i++)
+		ck_assert(!adaptive_timeout_add_gap(&at, ms2us(40)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(180));
+
+	/* longest gap plus margin, but no less than min_timeout */
+	ck_assert(adaptive_timeout_add_gap(&at, ms2us(40)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(100));
+	ck_assert(!adaptive_timeout_add_gap(&at, ms2us(40)));
+
+	ck_assert(adaptive_timeout_add_gap(&at, ms2us(120)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(150));
+
+	/* the long gap is forgotten once 16 newer ones are recorded */
+	for (i = 0; i < 15; i++)
+		ck_assert(!adaptive_timeout_add_gap(&at, ms2us(40)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(150));
+	ck_assert(adaptive_timeout_add_gap(&at, ms2us(40)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(100));
+
+	/* an event just after the shortened timeout is a miss */
+	adaptive_timeout_expired(&at, time);
+	ck_assert(adaptive_timeout_check_expired(&at, time + ms2us(130)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(160));
+
+	/* an event after max_timeout is not */
+	time += s2us(1);
+	adaptive_timeout_expired(&at, time);
+	ck_assert(!adaptive_timeout_check_expired(&at, time + ms2us(200)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(160));
+
+	/* neither is anything after clearing the expired timeout */
+	time += s2us(1);
+	adaptive_timeout_expired(&at, time);
+	adaptive_timeout_clear_expired(&at);
+	ck_assert(!adaptive_timeout_check_expired(&at, time + ms2us(50)));
+	ck_assert_int_eq(adaptive_timeout_get(&at), ms2us(160));
+}
+END_TEST
+
 struct parser_test {
 	char *tag;
 	int expected_value;
@@ -1785,6 +2143,12 @@ TEST_COLLECTION(misc)
 	litest_add_for_device("events:conversion", event_conversion_tablet, LITEST_WACOM_CINTIQ);
 	litest_add_for_device("events:conversion", event_conversion_tablet_pad, LITEST_WACOM_INTUOS5_PAD);
 	litest_add_for_device("events:conversion", event_conversion_switch, LITEST_LID_SWITCH);
+	litest_add_for_device("events:data", event_data_pointer, LITEST_MOUSE);
+	litest_add_for_device("events:data", event_data_size, LITEST_MOUSE);
+	litest_add_for_device("events:data", event_data_batch, LITEST_KEYBOARD);
+	litest_add_for_device("events:frame", event_frame_id, LITEST_MOUSE);
+	litest_add_for_device("events:frame", event_frame_id_suspend, LITEST_KEYBOARD);
+	litest_add_no_device("events:data", event_data_batch_device_removed);
 	litest_add_deviceless("misc:bitfield_helpers", bitfield_helpers);
 
 	litest_add_deviceless("context:refcount", context_ref_counting);
@@ -1795,6 +2159,8 @@ TEST_COLLECTION(misc)
 
 	litest_add_deviceless("misc:matrix", matrix_helpers);
 	litest_add_deviceless("misc:ratelimit", ratelimit_helpers);
+	litest_add_deviceless("misc:report-rate", report_rate_helpers);
+	litest_add_deviceless("misc:adaptive-timeout", adaptive_timeout_helpers);
 	litest_add_deviceless("misc:parser", dpi_parser);
 	litest_add_deviceless("misc:parser", wheel_click_parser);
 	litest_add_deviceless("misc:parser", wheel_click_count_parser);
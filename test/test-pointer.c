@@ -489,6 +489,140 @@ START_TEST(pointer_button_has_no_button)
 }
 END_TEST
 
+START_TEST(pointer_report_rate)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput *li = dev->libinput;
+
+	ck_assert_int_eq(libinput_device_pointer_get_report_rate(device), 0);
+
+	/* A single frame has no interval. uinput timestamps events when
+	 * they're written, so the estimate itself is tested with explicit
+	 * timestamps in report_rate_helpers */
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+	ck_assert_int_eq(libinput_device_pointer_get_report_rate(device), 0);
+
+	litest_drain_events(li);
+}
+END_TEST
+
+START_TEST(pointer_report_rate_invalid)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+
+	ck_assert_int_eq(libinput_device_pointer_get_report_rate(device), -1);
+}
+END_TEST
+
+START_TEST(pointer_event_type_disabled)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	enum libinput_event_type type = LIBINPUT_EVENT_POINTER_MOTION;
+
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_get_event_type_enabled(li, type), 1);
+	ck_assert_int_eq(libinput_set_event_type_enabled(li, type, 0), 0);
+	ck_assert_int_eq(libinput_get_event_type_enabled(li, type), 0);
+
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_REL, REL_Y, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	ck_assert_int_eq(libinput_set_event_type_enabled(li, type, 1), 0);
+
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_REL, REL_Y, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+	litest_assert_only_typed_events(li, type);
+}
+END_TEST
+
+START_TEST(pointer_event_type_disabled_invalid)
+{
+	struct libinput *li = litest_create_context();
+
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_DEVICE_ADDED,
+					 0),
+			 -1);
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_DEVICE_REMOVED,
+					 0),
+			 -1);
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_NONE,
+					 0),
+			 -1);
+	ck_assert_int_eq(libinput_get_event_type_enabled(li,
+					 LIBINPUT_EVENT_DEVICE_ADDED),
+			 1);
+
+	libinput_unref(li);
+}
+END_TEST
+
+START_TEST(pointer_event_type_disabled_sequence)
+{
+	struct libinput *li = litest_create_context();
+	enum libinput_event_type type;
+
+	/* Disabling one half of a sequence disables all of it */
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_TOUCH_UP,
+					 0),
+			 0);
+	for (type = LIBINPUT_EVENT_TOUCH_DOWN;
+	     type <= LIBINPUT_EVENT_TOUCH_CANCEL;
+	     type++)
+		ck_assert_int_eq(libinput_get_event_type_enabled(li, type), 0);
+	ck_assert_int_eq(libinput_get_event_type_enabled(li,
+					 LIBINPUT_EVENT_TOUCH_FRAME),
+			 1);
+
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_TOUCH_MOTION,
+					 1),
+			 0);
+	for (type = LIBINPUT_EVENT_TOUCH_DOWN;
+	     type <= LIBINPUT_EVENT_TOUCH_CANCEL;
+	     type++)
+		ck_assert_int_eq(libinput_get_event_type_enabled(li, type), 1);
+
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_GESTURE_SWIPE_END,
+					 0),
+			 0);
+	for (type = LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN;
+	     type <= LIBINPUT_EVENT_GESTURE_SWIPE_END;
+	     type++)
+		ck_assert_int_eq(libinput_get_event_type_enabled(li, type), 0);
+	for (type = LIBINPUT_EVENT_GESTURE_PINCH_BEGIN;
+	     type <= LIBINPUT_EVENT_GESTURE_PINCH_END;
+	     type++)
+		ck_assert_int_eq(libinput_get_event_type_enabled(li, type), 1);
+
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_GESTURE_PINCH_BEGIN,
+					 0),
+			 0);
+	for (type = LIBINPUT_EVENT_GESTURE_PINCH_BEGIN;
+	     type <= LIBINPUT_EVENT_GESTURE_PINCH_END;
+	     type++)
+		ck_assert_int_eq(libinput_get_event_type_enabled(li, type), 0);
+
+	libinput_unref(li);
+}
+END_TEST
+
 START_TEST(pointer_recover_from_lost_button_count)
 {
 	struct litest_device *dev = litest_current_device();
@@ -1953,6 +2087,99 @@ START_TEST(middlebutton_default_disabled)
 }
 END_TEST
 
+START_TEST(middlebutton_adaptive_timeout_default)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_middle_emulation_adaptive_timeout_state state;
+	enum libinput_config_status status;
+
+	if (!libinput_device_config_middle_emulation_is_available(device))
+		return;
+
+	state = libinput_device_config_middle_emulation_get_adaptive_timeout_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED);
+	state = libinput_device_config_middle_emulation_get_default_adaptive_timeout_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED);
+
+	status = libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(device,
+				     LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	state = libinput_device_config_middle_emulation_get_adaptive_timeout_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED);
+
+	status = libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(device,
+				     LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	status = libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(device, 3);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+}
+END_TEST
+
+START_TEST(middlebutton_adaptive_timeout_unavailable)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_middle_emulation_adaptive_timeout_state state;
+	enum libinput_config_status status;
+
+	state = libinput_device_config_middle_emulation_get_adaptive_timeout_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED);
+	state = libinput_device_config_middle_emulation_get_default_adaptive_timeout_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED);
+
+	status = libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(device,
+				     LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_UNSUPPORTED);
+	status = libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(device,
+				     LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_DISABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+}
+END_TEST
+
+START_TEST(middlebutton_adaptive_timeout)
+{
+	struct litest_device *device = litest_current_device();
+	struct libinput *li = device->libinput;
+	enum libinput_config_status status;
+
+	disable_button_scrolling(device);
+
+	status = libinput_device_config_middle_emulation_set_enabled(
+					    device->libinput_device,
+					    LIBINPUT_CONFIG_MIDDLE_EMULATION_ENABLED);
+	if (status == LIBINPUT_CONFIG_STATUS_UNSUPPORTED)
+		return;
+
+	status = libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(
+					    device->libinput_device,
+					    LIBINPUT_CONFIG_MIDDLE_EMULATION_ADAPTIVE_TIMEOUT_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	litest_drain_events(li);
+
+	/* Nothing learned yet, so this behaves like the default timeout.
+	 * The learning is tested with explicit timestamps in
+	 * adaptive_timeout_helpers */
+	litest_button_click(device, BTN_LEFT, true);
+	libinput_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	litest_timeout_middlebutton();
+	libinput_dispatch(li);
+	litest_assert_button_event(li,
+				   BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_PRESSED);
+
+	litest_button_click_debounced(device, li, BTN_LEFT, false);
+	litest_assert_button_event(li,
+				   BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_RELEASED);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
 START_TEST(middlebutton_button_scrolling)
 {
 	struct litest_device *dev = litest_current_device();
@@ -2385,15 +2612,15 @@ START_TEST(debounce_spurious_dont_enable_on_otherbutton)
 				   BTN_LEFT,
 				   LIBINPUT_BUTTON_STATE_RELEASED);
 
+	/* The left button bounce is debounced independently of the right
+	 * button, the quick right click is delayed until the timeout */
 	litest_assert_button_event(li,
 				   BTN_RIGHT,
 				   LIBINPUT_BUTTON_STATE_PRESSED);
-	litest_assert_button_event(li,
-				   BTN_LEFT,
-				   LIBINPUT_BUTTON_STATE_PRESSED);
-	litest_assert_button_event(li,
-				   BTN_LEFT,
-				   LIBINPUT_BUTTON_STATE_RELEASED);
+	litest_assert_empty_queue(li);
+
+	litest_timeout_debounce();
+	libinput_dispatch(li);
 	litest_assert_button_event(li,
 				   BTN_RIGHT,
 				   LIBINPUT_BUTTON_STATE_RELEASED);
@@ -2419,7 +2646,7 @@ START_TEST(debounce_spurious_dont_enable_on_otherbutton)
 }
 END_TEST
 
-START_TEST(debounce_spurious_cancel_debounce_otherbutton)
+START_TEST(debounce_spurious_otherbutton_independent)
 {
 	struct litest_device *dev = litest_current_device();
 	struct libinput_device *device = dev->libinput_device;
@@ -2440,8 +2667,8 @@ START_TEST(debounce_spurious_cancel_debounce_otherbutton)
 	litest_timeout_debounce();
 	libinput_dispatch(li);
 
-	/* spurious debouncing is on but the release should get flushed by
-	 * the other button */
+	/* spurious debouncing is on, the other button must not flush the
+	 * left button's release */
 	litest_event(dev, EV_KEY, BTN_LEFT, 0);
 	litest_event(dev, EV_SYN, SYN_REPORT, 0);
 	litest_event(dev, EV_KEY, BTN_RIGHT, 1);
@@ -2458,16 +2685,14 @@ START_TEST(debounce_spurious_cancel_debounce_otherbutton)
 	litest_assert_button_event(li,
 				   BTN_LEFT,
 				   LIBINPUT_BUTTON_STATE_PRESSED);
-	litest_assert_button_event(li,
-				   BTN_LEFT,
-				   LIBINPUT_BUTTON_STATE_RELEASED);
-
 	litest_assert_button_event(li,
 				   BTN_RIGHT,
 				   LIBINPUT_BUTTON_STATE_PRESSED);
-	litest_assert_button_event(li,
-				   BTN_LEFT,
-				   LIBINPUT_BUTTON_STATE_PRESSED);
+	litest_assert_empty_queue(li);
+
+	litest_timeout_debounce();
+	libinput_dispatch(li);
+
 	litest_assert_button_event(li,
 				   BTN_LEFT,
 				   LIBINPUT_BUTTON_STATE_RELEASED);
@@ -2488,6 +2713,7 @@ START_TEST(debounce_spurious_switch_to_otherbutton)
 	if (!libinput_device_config_middle_emulation_is_available(device))
 		return;
 
+	litest_disable_middleemu(dev);
 	litest_drain_events(li);
 	debounce_trigger_spurious(dev, li);
 
@@ -2499,8 +2725,8 @@ START_TEST(debounce_spurious_switch_to_otherbutton)
 
 	litest_event(dev, EV_KEY, BTN_LEFT, 0);
 	litest_event(dev, EV_SYN, SYN_REPORT, 0);
-	/* release is now held back,
-	 * other button should flush the release */
+	/* release is now held back, the right button is debounced
+	 * independently */
 	litest_event(dev, EV_KEY, BTN_RIGHT, 1);
 	litest_event(dev, EV_SYN, SYN_REPORT, 0);
 	litest_event(dev, EV_KEY, BTN_RIGHT, 0);
@@ -2517,17 +2743,79 @@ START_TEST(debounce_spurious_switch_to_otherbutton)
 	litest_assert_button_event(li,
 				   BTN_LEFT,
 				   LIBINPUT_BUTTON_STATE_PRESSED);
+	litest_assert_button_event(li,
+				   BTN_RIGHT,
+				   LIBINPUT_BUTTON_STATE_PRESSED);
+	litest_assert_empty_queue(li);
+
+	litest_timeout_debounce();
+	libinput_dispatch(li);
+
 	litest_assert_button_event(li,
 				   BTN_LEFT,
 				   LIBINPUT_BUTTON_STATE_RELEASED);
+	litest_assert_button_event(li,
+				   BTN_RIGHT,
+				   LIBINPUT_BUTTON_STATE_RELEASED);
 
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+START_TEST(debounce_multiple_buttons_same_frame)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput *li = dev->libinput;
+
+	if (!libinput_device_config_middle_emulation_is_available(device))
+		return;
+
+	litest_disable_middleemu(dev);
+	disable_button_scrolling(dev);
+	litest_drain_events(li);
+
+	/* Both buttons bounce within the same frames, each must be
+	 * debounced */
+	litest_event(dev, EV_KEY, BTN_LEFT, 1);
+	litest_event(dev, EV_KEY, BTN_RIGHT, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_event(dev, EV_KEY, BTN_LEFT, 0);
+	litest_event(dev, EV_KEY, BTN_RIGHT, 0);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_event(dev, EV_KEY, BTN_LEFT, 1);
+	litest_event(dev, EV_KEY, BTN_RIGHT, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	litest_assert_button_event(li,
+				   BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_PRESSED);
 	litest_assert_button_event(li,
 				   BTN_RIGHT,
 				   LIBINPUT_BUTTON_STATE_PRESSED);
+	litest_assert_empty_queue(li);
+
+	litest_timeout_debounce();
+	libinput_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	/* held down & past timeout, releases are immediate */
+	litest_event(dev, EV_KEY, BTN_LEFT, 0);
+	litest_event(dev, EV_KEY, BTN_RIGHT, 0);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	litest_assert_button_event(li,
+				   BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_RELEASED);
 	litest_assert_button_event(li,
 				   BTN_RIGHT,
 				   LIBINPUT_BUTTON_STATE_RELEASED);
+	litest_assert_empty_queue(li);
 
+	litest_timeout_debounce();
+	libinput_dispatch(li);
 	litest_assert_empty_queue(li);
 }
 END_TEST
@@ -2595,6 +2883,11 @@ TEST_COLLECTION(pointer)
 	litest_add_ranged("pointer:motion", pointer_motion_relative_min_decel, LITEST_RELATIVE, LITEST_POINTINGSTICK, &compass);
 	litest_add("pointer:motion", pointer_motion_absolute, LITEST_ABSOLUTE, LITEST_ANY);
 	litest_add("pointer:motion", pointer_motion_unaccel, LITEST_RELATIVE, LITEST_ANY);
+	litest_add("pointer:motion", pointer_report_rate, LITEST_RELATIVE, LITEST_ANY);
+	litest_add_for_device("pointer:motion", pointer_report_rate_invalid, LITEST_KEYBOARD);
+	litest_add("pointer:motion", pointer_event_type_disabled, LITEST_RELATIVE, LITEST_ANY);
+	litest_add_no_device("pointer:motion", pointer_event_type_disabled_invalid);
+	litest_add_no_device("pointer:motion", pointer_event_type_disabled_sequence);
 	litest_add("pointer:button", pointer_button, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add_no_device("pointer:button", pointer_button_auto_release);
 	litest_add_no_device("pointer:button", pointer_seat_button_count);
@@ -2644,6 +2937,9 @@ TEST_COLLECTION(pointer)
 	litest_add("pointer:middlebutton", middlebutton_default_touchpad, LITEST_TOUCHPAD, LITEST_CLICKPAD);
 	litest_add("pointer:middlebutton", middlebutton_default_disabled, LITEST_ANY, LITEST_BUTTON);
 	litest_add_for_device("pointer:middlebutton", middlebutton_default_alps, LITEST_ALPS_SEMI_MT);
+	litest_add("pointer:middlebutton", middlebutton_adaptive_timeout_default, LITEST_BUTTON, LITEST_ANY);
+	litest_add("pointer:middlebutton", middlebutton_adaptive_timeout_unavailable, LITEST_ANY, LITEST_BUTTON);
+	litest_add("pointer:middlebutton", middlebutton_adaptive_timeout, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add("pointer:middlebutton", middlebutton_button_scrolling, LITEST_RELATIVE|LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add("pointer:middlebutton", middlebutton_button_scrolling_middle, LITEST_RELATIVE|LITEST_BUTTON, LITEST_CLICKPAD);
 
@@ -2656,8 +2952,9 @@ TEST_COLLECTION(pointer)
 	litest_add_ranged("pointer:debounce", debounce_spurious, LITEST_BUTTON, LITEST_TOUCHPAD|LITEST_NO_DEBOUNCE, &buttons);
 	litest_add("pointer:debounce", debounce_spurious_multibounce, LITEST_BUTTON, LITEST_TOUCHPAD|LITEST_NO_DEBOUNCE);
 	litest_add("pointer:debounce_otherbutton", debounce_spurious_dont_enable_on_otherbutton, LITEST_BUTTON, LITEST_TOUCHPAD|LITEST_NO_DEBOUNCE);
-	litest_add("pointer:debounce_otherbutton", debounce_spurious_cancel_debounce_otherbutton, LITEST_BUTTON, LITEST_TOUCHPAD|LITEST_NO_DEBOUNCE);
+	litest_add("pointer:debounce_otherbutton", debounce_spurious_otherbutton_independent, LITEST_BUTTON, LITEST_TOUCHPAD|LITEST_NO_DEBOUNCE);
 	litest_add("pointer:debounce_otherbutton", debounce_spurious_switch_to_otherbutton, LITEST_BUTTON, LITEST_TOUCHPAD|LITEST_NO_DEBOUNCE);
+	litest_add("pointer:debounce_otherbutton", debounce_multiple_buttons_same_frame, LITEST_BUTTON, LITEST_TOUCHPAD|LITEST_NO_DEBOUNCE);
 	litest_add_no_device("pointer:debounce", debounce_remove_device_button_down);
 	litest_add_no_device("pointer:debounce", debounce_remove_device_button_up);
 }
@@ -1809,6 +1809,164 @@ START_TEST(left_handed_artpen_rotation)
 }
 END_TEST
 
+START_TEST(motion_predicted_position)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event, *last = NULL;
+	struct libinput_event_tablet_tool *tev;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 }
+	};
+	uint64_t time;
+	double x, y;
+	int i;
+
+	libinput_set_prediction_method(li, LIBINPUT_PREDICTION_QUADRATIC);
+
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	litest_drain_events(li);
+
+	for (i = 11; i < 50; i++) {
+		litest_tablet_motion(dev, i, i, axes);
+		msleep(2);
+	}
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		libinput_event_destroy(last);
+		last = event;
+	}
+
+	tev = litest_is_tablet_event(last, LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+	time = libinput_event_tablet_tool_get_time_usec(tev);
+	x = libinput_event_tablet_tool_get_x_transformed(tev, 1000);
+	y = libinput_event_tablet_tool_get_y_transformed(tev, 1000);
+
+	litest_assert_double_gt(
+		libinput_event_tablet_tool_get_predicted_x_transformed(tev,
+								       time + ms2us(5),
+								       1000),
+		x);
+	litest_assert_double_gt(
+		libinput_event_tablet_tool_get_predicted_y_transformed(tev,
+								       time + ms2us(5),
+								       1000),
+		y);
+	litest_assert_double_eq(
+		libinput_event_tablet_tool_get_predicted_x_transformed(tev,
+								       time,
+								       1000),
+		x);
+
+	libinput_event_destroy(last);
+}
+END_TEST
+
+START_TEST(motion_smoothing_config)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	struct libinput_tablet_tool *tool;
+	enum libinput_config_status status;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 }
+	};
+
+	litest_drain_events(li);
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	tev = litest_is_tablet_event(event,
+				     LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	tool = libinput_event_tablet_tool_get_tool(tev);
+
+	ck_assert_int_eq(libinput_tablet_tool_config_smoothing_get_method(tool),
+			 LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE);
+	ck_assert_int_eq(libinput_tablet_tool_config_smoothing_get_default_method(tool),
+			 LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE);
+
+	status = libinput_tablet_tool_config_smoothing_set_method(tool,
+					LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	ck_assert_int_eq(libinput_tablet_tool_config_smoothing_get_method(tool),
+			 LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE);
+
+	status = libinput_tablet_tool_config_smoothing_set_method(tool, 3);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	ck_assert_int_eq(libinput_tablet_tool_config_smoothing_get_method(tool),
+			 LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE);
+
+	libinput_event_destroy(event);
+}
+END_TEST
+
+START_TEST(motion_smoothing)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	struct libinput_tablet_tool *tool;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 }
+	};
+	enum libinput_config_tablet_tool_smoothing method = _i; /* ranged test */
+	double x, last_x = 0;
+	int i;
+
+	litest_drain_events(li);
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	tev = litest_is_tablet_event(event,
+				     LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	tool = libinput_event_tablet_tool_get_tool(tev);
+	libinput_tablet_tool_config_smoothing_set_method(tool, method);
+	libinput_event_destroy(event);
+
+	/* the new method takes effect from here */
+	litest_tablet_motion(dev, 10, 11, axes);
+	litest_drain_events(li);
+
+	/* a jump in x, followed by a slow y movement only, the smoothed x
+	 * position must approach the tool without overshooting */
+	for (i = 0; i < 20; i++) {
+		litest_tablet_motion(dev, 50, 12 + i, axes);
+		msleep(5);
+		libinput_dispatch(li);
+
+		event = libinput_get_event(li);
+		tev = litest_is_tablet_event(event,
+					     LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+		x = libinput_event_tablet_tool_get_x_transformed(tev, 100);
+		libinput_event_destroy(event);
+
+		if (method == LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_NONE)
+			litest_assert_double_ge(x, 49.0);
+		else if (i == 0)
+			litest_assert_double_lt(x, 49.0);
+
+		litest_assert_double_ge(x, last_x);
+		litest_assert_double_le(x, 51.0);
+		last_x = x;
+	}
+
+	litest_assert_double_ge(x, 49.0);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
 START_TEST(motion_event_state)
 {
 	struct litest_device *dev = litest_current_device();
@@ -4678,6 +4836,8 @@ END_TEST
 TEST_COLLECTION(tablet)
 {
 	struct range with_timeout = { 0, 2 };
+	struct range smoothing_methods = { LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_NONE,
+					   LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE + 1 };
 
 	litest_add("tablet:tool", tool_ref, LITEST_TABLET | LITEST_TOOL_SERIAL, LITEST_ANY);
 	litest_add("tablet:tool", tool_user_data, LITEST_TABLET | LITEST_TOOL_SERIAL, LITEST_ANY);
@@ -4721,6 +4881,9 @@ TEST_COLLECTION(tablet)
 	litest_add_no_device("tablet:tip", tip_up_on_delete);
 	litest_add("tablet:motion", motion, LITEST_TABLET, LITEST_ANY);
 	litest_add("tablet:motion", motion_event_state, LITEST_TABLET, LITEST_ANY);
+	litest_add("tablet:motion", motion_predicted_position, LITEST_TABLET, LITEST_ANY);
+	litest_add("tablet:motion", motion_smoothing_config, LITEST_TABLET, LITEST_ANY);
+	litest_add_ranged("tablet:motion", motion_smoothing, LITEST_TABLET, LITEST_ANY, &smoothing_methods);
 	litest_add_for_device("tablet:motion", motion_outside_bounds, LITEST_WACOM_CINTIQ_24HD);
 	litest_add("tablet:tilt", tilt_available, LITEST_TABLET|LITEST_TILT, LITEST_ANY);
 	litest_add("tablet:tilt", tilt_not_available, LITEST_TABLET, LITEST_TILT);
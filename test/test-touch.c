@@ -64,6 +64,51 @@ START_TEST(touch_frame_events)
 }
 END_TEST
 
+START_TEST(touch_events_disabled)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+
+	litest_drain_events(li);
+
+	/* Disables the whole touch sequence, only frames remain */
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_TOUCH_UP,
+					 0),
+			 0);
+
+	litest_touch_down(dev, 0, 10, 10);
+	litest_touch_move_to(dev, 0, 10, 10, 20, 20, 5, 0);
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+	litest_assert_only_typed_events(li, LIBINPUT_EVENT_TOUCH_FRAME);
+
+	ck_assert_int_eq(libinput_set_event_type_enabled(li,
+					 LIBINPUT_EVENT_TOUCH_DOWN,
+					 1),
+			 0);
+
+	litest_touch_down(dev, 0, 10, 10);
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_DOWN);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_UP);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
 START_TEST(touch_abs_transform)
 {
 	struct litest_device *dev;
@@ -241,6 +286,68 @@ START_TEST(touch_many_slots)
 }
 END_TEST
 
+START_TEST(touch_many_slots_seat_slots)
+{
+	struct libinput *libinput;
+	struct litest_device *dev;
+	struct libinput_event *ev;
+	struct libinput_event_touch *tev;
+	const int num_tps = 100;
+	unsigned char seen[NCHARS(100)] = {0};
+	int ndown = 0;
+	int slot;
+
+	struct input_absinfo abs[] = {
+		{ ABS_MT_SLOT, 0, num_tps - 1, 0, 0, 0 },
+		{ .value = -1 },
+	};
+
+	dev = litest_create_device_with_overrides(LITEST_WACOM_TOUCH,
+						  "litest Multi-touch device",
+						  NULL, abs, NULL);
+	libinput = dev->libinput;
+	litest_drain_events(libinput);
+
+	/* More touches than fit into a 32-bit seat slot map, each must
+	 * get its own seat slot */
+	for (slot = 0; slot < num_tps; ++slot)
+		litest_touch_down(dev, slot, slot % 10 * 10, slot / 10 * 10);
+	libinput_dispatch(libinput);
+
+	while ((ev = libinput_get_event(libinput))) {
+		if (libinput_event_get_type(ev) == LIBINPUT_EVENT_TOUCH_DOWN) {
+			int seat_slot;
+
+			tev = libinput_event_get_touch_event(ev);
+			seat_slot = libinput_event_touch_get_seat_slot(tev);
+			ck_assert_int_ge(seat_slot, 0);
+			ck_assert_int_lt(seat_slot, num_tps);
+			ck_assert(!bit_is_set(seen, seat_slot));
+			set_bit(seen, seat_slot);
+			ndown++;
+		}
+		libinput_event_destroy(ev);
+	}
+	ck_assert_int_eq(ndown, num_tps);
+
+	/* A freed seat slot is reused for the next touch */
+	litest_touch_up(dev, 40);
+	litest_drain_events(libinput);
+	litest_touch_down(dev, 40, 50, 50);
+	libinput_dispatch(libinput);
+	ev = libinput_get_event(libinput);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_DOWN);
+	ck_assert_int_lt(libinput_event_touch_get_seat_slot(tev), num_tps);
+	libinput_event_destroy(ev);
+
+	for (slot = 0; slot < num_tps; ++slot)
+		litest_touch_up(dev, slot);
+	litest_drain_events(libinput);
+
+	litest_delete_device(dev);
+}
+END_TEST
+
 START_TEST(touch_double_touch_down_up)
 {
 	struct libinput *libinput;
@@ -566,6 +673,106 @@ START_TEST(touch_calibrated_screen_udev)
 }
 END_TEST
 
+START_TEST(touch_predicted_position)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event, *last = NULL;
+	struct libinput_event_touch *tev;
+	uint64_t time;
+	double x, y;
+
+	ck_assert_int_eq(libinput_get_prediction_method(li),
+			 LIBINPUT_PREDICTION_NONE);
+	ck_assert_int_eq(libinput_set_prediction_method(li, 10), -1);
+	ck_assert_int_eq(libinput_set_prediction_method(li,
+							LIBINPUT_PREDICTION_LINEAR),
+			 0);
+	ck_assert_int_eq(libinput_get_prediction_method(li),
+			 LIBINPUT_PREDICTION_LINEAR);
+
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 20, 50);
+	litest_touch_move_to(dev, 0, 20, 50, 60, 50, 10, 2);
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		if (libinput_event_get_type(event) ==
+		    LIBINPUT_EVENT_TOUCH_MOTION) {
+			libinput_event_destroy(last);
+			last = event;
+		} else {
+			libinput_event_destroy(event);
+		}
+	}
+
+	ck_assert_notnull(last);
+	tev = libinput_event_get_touch_event(last);
+	time = libinput_event_touch_get_time_usec(tev);
+	x = libinput_event_touch_get_x_transformed(tev, 1000);
+	y = libinput_event_touch_get_y_transformed(tev, 1000);
+
+	/* moving right, so the prediction is further right */
+	litest_assert_double_gt(
+		libinput_event_touch_get_predicted_x_transformed(tev,
+								 time + ms2us(10),
+								 1000),
+		x);
+	litest_assert_double_eq(
+		libinput_event_touch_get_predicted_y_transformed(tev,
+								 time + ms2us(10),
+								 1000),
+		y);
+
+	/* no prediction into the past */
+	litest_assert_double_eq(
+		libinput_event_touch_get_predicted_x_transformed(tev,
+								 time,
+								 1000),
+		x);
+	litest_assert_double_eq(
+		libinput_event_touch_get_predicted_x_transformed(tev,
+								 time - ms2us(10),
+								 1000),
+		x);
+
+	libinput_event_destroy(last);
+	litest_touch_up(dev, 0);
+}
+END_TEST
+
+START_TEST(touch_predicted_position_disabled)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_touch *tev;
+	uint64_t time;
+	double x;
+
+	litest_touch_down(dev, 0, 20, 50);
+	litest_touch_move_to(dev, 0, 20, 50, 60, 50, 10, 2);
+	litest_drain_events(li);
+
+	litest_touch_move_to(dev, 0, 60, 50, 70, 50, 1, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	tev = litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_MOTION);
+	time = libinput_event_touch_get_time_usec(tev);
+	x = libinput_event_touch_get_x_transformed(tev, 1000);
+	litest_assert_double_eq(
+		libinput_event_touch_get_predicted_x_transformed(tev,
+								 time + ms2us(10),
+								 1000),
+		x);
+	libinput_event_destroy(event);
+
+	litest_touch_up(dev, 0);
+}
+END_TEST
+
 START_TEST(touch_no_left_handed)
 {
 	struct litest_device *dev = litest_current_device();
@@ -718,7 +925,7 @@ START_TEST(touch_protocol_a_2fg_touch)
 
 	litest_push_event_frame(dev);
 	litest_touch_down(dev, 0, 5, 95);
-	litest_touch_down(dev, 0, 95, 5);
+	litest_touch_down(dev, 1, 95, 5);
 	litest_pop_event_frame(dev);
 
 	libinput_dispatch(li);
@@ -737,7 +944,7 @@ START_TEST(touch_protocol_a_2fg_touch)
 	for (pos = 10; pos < 100; pos += 10) {
 		litest_push_event_frame(dev);
 		litest_touch_move_to(dev, 0, pos, 100 - pos, pos, 100 - pos, 1, 1);
-		litest_touch_move_to(dev, 0, 100 - pos, pos, 100 - pos, pos, 1, 1);
+		litest_touch_move_to(dev, 1, 100 - pos, pos, 100 - pos, pos, 1, 1);
 		litest_pop_event_frame(dev);
 		libinput_dispatch(li);
 
@@ -776,6 +983,158 @@ START_TEST(touch_protocol_a_2fg_touch)
 }
 END_TEST
 
+START_TEST(touch_protocol_a_contact_order)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *ev;
+	struct libinput_event_touch *tev;
+	double x;
+
+	litest_drain_events(li);
+
+	litest_push_event_frame(dev);
+	litest_touch_down(dev, 0, 20, 50);
+	litest_touch_down(dev, 1, 80, 50);
+	litest_pop_event_frame(dev);
+	litest_drain_events(li);
+
+	/* Protocol A contacts are unordered, the kernel may report
+	 * them in a different order in the next frame */
+	litest_push_event_frame(dev);
+	litest_touch_move(dev, 1, 82, 52);
+	litest_touch_move(dev, 0, 22, 52);
+	litest_pop_event_frame(dev);
+	libinput_dispatch(li);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_MOTION);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 0);
+	x = libinput_event_touch_get_x_transformed(tev, 100);
+	ck_assert_double_lt(x, 50.0);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_MOTION);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 1);
+	x = libinput_event_touch_get_x_transformed(tev, 100);
+	ck_assert_double_gt(x, 50.0);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(ev);
+
+	/* one contact lifted, the remaining one keeps its slot */
+	litest_touch_move(dev, 1, 84, 54);
+	libinput_dispatch(li);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_UP);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 0);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_MOTION);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 1);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(ev);
+}
+END_TEST
+
+/* mtdev matches Protocol A contacts by position only, these tests check
+ * the built-in tracking's use of ABS_MT_TRACKING_ID */
+#if !HAVE_MTDEV
+START_TEST(touch_protocol_a_tracking_id_crossing)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *ev;
+	struct libinput_event_touch *tev;
+	double x;
+
+	litest_drain_events(li);
+
+	litest_push_event_frame(dev);
+	litest_touch_down(dev, 0, 40, 50);
+	litest_touch_down(dev, 1, 60, 50);
+	litest_pop_event_frame(dev);
+	litest_drain_events(li);
+
+	/* The contacts swap sides within one frame, closer to the other
+	 * contact's previous position. The tracking ID wins over the
+	 * distance. */
+	litest_push_event_frame(dev);
+	litest_touch_move(dev, 1, 38, 50);
+	litest_touch_move(dev, 0, 62, 50);
+	litest_pop_event_frame(dev);
+	libinput_dispatch(li);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_MOTION);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 0);
+	x = libinput_event_touch_get_x_transformed(tev, 100);
+	ck_assert_double_gt(x, 50.0);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_MOTION);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 1);
+	x = libinput_event_touch_get_x_transformed(tev, 100);
+	ck_assert_double_lt(x, 50.0);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(ev);
+
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+START_TEST(touch_protocol_a_tracking_id_untracked_contact)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *ev;
+	struct libinput_event_touch *tev;
+
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 50, 50);
+	litest_drain_events(li);
+
+	/* The tracked contact is gone, an untracked contact appears
+	 * right next to it. It must not continue the tracked slot.
+	 * The axis range is 0-32767, so this is roughly at 51/51. */
+	litest_event(dev, EV_ABS, ABS_MT_POSITION_X, 16700);
+	litest_event(dev, EV_ABS, ABS_MT_POSITION_Y, 16700);
+	litest_event(dev, EV_SYN, SYN_MT_REPORT, 0);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_UP);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 0);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	tev = litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_DOWN);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 1);
+	libinput_event_destroy(ev);
+
+	ev = libinput_get_event(li);
+	litest_is_touch_event(ev, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(ev);
+
+	litest_assert_empty_queue(li);
+}
+END_TEST
+#endif
+
 START_TEST(touch_initial_state)
 {
 	struct litest_device *dev;
@@ -1066,9 +1425,11 @@ TEST_COLLECTION(touch)
 	struct range axes = { ABS_X, ABS_Y + 1};
 
 	litest_add("touch:frame", touch_frame_events, LITEST_TOUCH, LITEST_ANY);
+	litest_add("touch:frame", touch_events_disabled, LITEST_TOUCH, LITEST_ANY);
 	litest_add_no_device("touch:abs-transform", touch_abs_transform);
 	litest_add("touch:slots", touch_seat_slot, LITEST_TOUCH, LITEST_TOUCHPAD);
 	litest_add_no_device("touch:slots", touch_many_slots);
+	litest_add_no_device("touch:slots", touch_many_slots_seat_slots);
 	litest_add("touch:double-touch-down-up", touch_double_touch_down_up, LITEST_TOUCH, LITEST_ANY);
 	litest_add("touch:calibration", touch_calibration_scale, LITEST_TOUCH, LITEST_TOUCHPAD);
 	litest_add("touch:calibration", touch_calibration_scale, LITEST_SINGLE_TOUCH, LITEST_TOUCHPAD);
@@ -1081,12 +1442,20 @@ TEST_COLLECTION(touch)
 
 	litest_add("touch:left-handed", touch_no_left_handed, LITEST_TOUCH, LITEST_ANY);
 
+	litest_add("touch:prediction", touch_predicted_position, LITEST_TOUCH, LITEST_ANY);
+	litest_add("touch:prediction", touch_predicted_position_disabled, LITEST_TOUCH, LITEST_ANY);
+
 	litest_add("touch:fake-mt", fake_mt_exists, LITEST_FAKE_MT, LITEST_ANY);
 	litest_add("touch:fake-mt", fake_mt_no_touch_events, LITEST_FAKE_MT, LITEST_ANY);
 
 	litest_add("touch:protocol a", touch_protocol_a_init, LITEST_PROTOCOL_A, LITEST_ANY);
 	litest_add("touch:protocol a", touch_protocol_a_touch, LITEST_PROTOCOL_A, LITEST_ANY);
 	litest_add("touch:protocol a", touch_protocol_a_2fg_touch, LITEST_PROTOCOL_A, LITEST_ANY);
+	litest_add("touch:protocol a", touch_protocol_a_contact_order, LITEST_PROTOCOL_A, LITEST_ANY);
+#if !HAVE_MTDEV
+	litest_add_for_device("touch:protocol a", touch_protocol_a_tracking_id_crossing, LITEST_PROTOCOL_A_SCREEN_TRACKING_ID);
+	litest_add_for_device("touch:protocol a", touch_protocol_a_tracking_id_untracked_contact, LITEST_PROTOCOL_A_SCREEN_TRACKING_ID);
+#endif
 
 	litest_add_ranged("touch:state", touch_initial_state, LITEST_TOUCH, LITEST_PROTOCOL_A, &axes);
 
@@ -2517,6 +2517,84 @@ START_TEST(touchpad_drag_lock_default_unavailable)
 }
 END_TEST
 
+START_TEST(touchpad_tap_adaptive_timeout_default)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_status status;
+
+	ck_assert_int_eq(libinput_device_config_tap_get_adaptive_timeout_enabled(device),
+			 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED);
+	ck_assert_int_eq(libinput_device_config_tap_get_default_adaptive_timeout_enabled(device),
+			 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED);
+
+	status = libinput_device_config_tap_set_adaptive_timeout_enabled(device,
+									 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	ck_assert_int_eq(libinput_device_config_tap_get_adaptive_timeout_enabled(device),
+			 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED);
+
+	status = libinput_device_config_tap_set_adaptive_timeout_enabled(device,
+									 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	status = libinput_device_config_tap_set_adaptive_timeout_enabled(device,
+									 3);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+}
+END_TEST
+
+START_TEST(touchpad_tap_adaptive_timeout_unavailable)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_status status;
+
+	ck_assert_int_eq(libinput_device_config_tap_get_adaptive_timeout_enabled(device),
+			 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED);
+	ck_assert_int_eq(libinput_device_config_tap_get_default_adaptive_timeout_enabled(device),
+			 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED);
+
+	status = libinput_device_config_tap_set_adaptive_timeout_enabled(device,
+									 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_UNSUPPORTED);
+
+	status = libinput_device_config_tap_set_adaptive_timeout_enabled(device,
+									 LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_DISABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+}
+END_TEST
+
+START_TEST(touchpad_tap_adaptive_timeout)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+
+	litest_enable_tap(dev->libinput_device);
+	litest_enable_tap_drag(dev->libinput_device);
+	libinput_device_config_tap_set_adaptive_timeout_enabled(dev->libinput_device,
+								LIBINPUT_CONFIG_TAP_ADAPTIVE_TIMEOUT_ENABLED);
+
+	litest_drain_events(li);
+
+	/* Nothing learned yet, so this behaves like the default timeout.
+	 * The learning is tested with explicit timestamps in
+	 * adaptive_timeout_helpers */
+	litest_touch_down(dev, 0, 50, 50);
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+
+	litest_assert_button_event(li, BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_PRESSED);
+	litest_timeout_tap();
+	libinput_dispatch(li);
+	litest_assert_button_event(li, BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_RELEASED);
+
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
 static inline bool
 touchpad_has_palm_pressure(struct litest_device *dev)
 {
@@ -3483,6 +3561,10 @@ TEST_COLLECTION(touchpad_tap)
 	litest_add("tap:draglock", touchpad_drag_lock_default_disabled, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("tap:draglock", touchpad_drag_lock_default_unavailable, LITEST_ANY, LITEST_TOUCHPAD);
 
+	litest_add("tap:adaptive", touchpad_tap_adaptive_timeout_default, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add("tap:adaptive", touchpad_tap_adaptive_timeout_unavailable, LITEST_ANY, LITEST_TOUCHPAD);
+	litest_add("tap:adaptive", touchpad_tap_adaptive_timeout, LITEST_TOUCHPAD, LITEST_ANY);
+
 	litest_add("tap:drag", touchpad_drag_default_disabled, LITEST_ANY, LITEST_TOUCHPAD);
 	litest_add("tap:drag", touchpad_drag_default_enabled, LITEST_TOUCHPAD, LITEST_BUTTON);
 	litest_add("tap:drag", touchpad_drag_config_invalid, LITEST_TOUCHPAD, LITEST_ANY);
@@ -86,6 +86,58 @@ START_TEST(touchpad_1fg_motion)
 }
 END_TEST
 
+START_TEST(touchpad_1fg_motion_resampled)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	enum libinput_config_status status;
+	int nevents = 0;
+
+	litest_disable_tap(device);
+
+	ck_assert(libinput_device_config_resample_is_available(device));
+	ck_assert_int_eq(libinput_device_config_resample_get_default_rate(device), 0);
+	ck_assert_int_eq(libinput_device_config_resample_get_rate(device), 0);
+
+	status = libinput_device_config_resample_set_rate(device, 1001);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_resample_set_rate(device, 250);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	ck_assert_int_eq(libinput_device_config_resample_get_rate(device), 250);
+
+	litest_drain_events(li);
+
+	/* 100Hz device resampled to 250Hz, so most frames are split
+	 * into three motion events */
+	litest_touch_down(dev, 0, 50, 50);
+	litest_touch_move_to(dev, 0, 50, 50, 80, 50, 10, 10);
+	litest_touch_up(dev, 0);
+
+	msleep(20);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	ck_assert(event != NULL);
+
+	while (event) {
+		ck_assert_int_eq(libinput_event_get_type(event),
+				 LIBINPUT_EVENT_POINTER_MOTION);
+
+		ptrev = libinput_event_get_pointer_event(event);
+		litest_assert_double_ge(libinput_event_pointer_get_dx(ptrev), 0.0);
+		litest_assert_double_eq(libinput_event_pointer_get_dy(ptrev), 0.0);
+		libinput_event_destroy(event);
+		nevents++;
+		event = libinput_get_event(li);
+	}
+
+	ck_assert_int_gt(nevents, 10);
+}
+END_TEST
+
 START_TEST(touchpad_2fg_no_motion)
 {
 	struct litest_device *dev = litest_current_device();
@@ -165,6 +217,92 @@ START_TEST(touchpad_2fg_scroll)
 }
 END_TEST
 
+START_TEST(touchpad_2fg_scroll_velocity)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	bool stopped = false;
+
+	if (!litest_has_2fg_scroll(dev))
+		return;
+
+	litest_enable_2fg_scroll(dev);
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 49, 50);
+	litest_touch_down(dev, 1, 51, 50);
+	litest_touch_move_two_touches(dev, 49, 50, 51, 50, 0, 30, 10, 2);
+	litest_touch_up(dev, 1);
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+
+	/* only the terminating event has a velocity */
+	while ((event = libinput_get_event(li))) {
+		double value, velocity;
+
+		ptrev = litest_is_axis_event(event,
+					     LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL,
+					     LIBINPUT_POINTER_AXIS_SOURCE_FINGER);
+		value = libinput_event_pointer_get_axis_value(ptrev,
+				LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+		velocity = libinput_event_pointer_get_axis_velocity(ptrev,
+				LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+		if (value == 0.0) {
+			litest_assert_double_gt(velocity, 0.0);
+			stopped = true;
+		} else {
+			litest_assert_double_eq(velocity, 0.0);
+		}
+		libinput_event_destroy(event);
+	}
+
+	ck_assert(stopped);
+}
+END_TEST
+
+START_TEST(touchpad_2fg_scroll_velocity_resting)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	double velocity;
+
+	if (!litest_has_2fg_scroll(dev))
+		return;
+
+	litest_enable_2fg_scroll(dev);
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 49, 50);
+	litest_touch_down(dev, 1, 51, 50);
+	litest_touch_move_two_touches(dev, 49, 50, 51, 50, 0, 30, 10, 2);
+	libinput_dispatch(li);
+	litest_drain_events(li);
+
+	/* fingers rest before they are lifted, no velocity */
+	msleep(200);
+	libinput_dispatch(li);
+	litest_touch_up(dev, 1);
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	ptrev = litest_is_axis_event(event,
+				     LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL,
+				     LIBINPUT_POINTER_AXIS_SOURCE_FINGER);
+	litest_assert_double_eq(libinput_event_pointer_get_axis_value(ptrev,
+					LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL),
+				0.0);
+	velocity = libinput_event_pointer_get_axis_velocity(ptrev,
+				LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+	litest_assert_double_eq(velocity, 0.0);
+	libinput_event_destroy(event);
+}
+END_TEST
+
 START_TEST(touchpad_2fg_scroll_diagonal)
 {
 	struct litest_device *dev = litest_current_device();
@@ -6330,10 +6468,13 @@ TEST_COLLECTION(touchpad)
 	struct range twice = {0, 2 };
 
 	litest_add("touchpad:motion", touchpad_1fg_motion, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add("touchpad:motion", touchpad_1fg_motion_resampled, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("touchpad:motion", touchpad_2fg_no_motion, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH);
 
 	litest_add("touchpad:scroll", touchpad_2fg_scroll, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH|LITEST_SEMI_MT);
 	litest_add("touchpad:scroll", touchpad_2fg_scroll_diagonal, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH|LITEST_SEMI_MT);
+	litest_add("touchpad:scroll", touchpad_2fg_scroll_velocity, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH|LITEST_SEMI_MT);
+	litest_add("touchpad:scroll", touchpad_2fg_scroll_velocity_resting, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH|LITEST_SEMI_MT);
 	litest_add("touchpad:scroll", touchpad_2fg_scroll_slow_distance, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH);
 	litest_add("touchpad:scroll", touchpad_2fg_scroll_return_to_motion, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH);
 	litest_add("touchpad:scroll", touchpad_2fg_scroll_source, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH);
@@ -426,8 +426,22 @@ print_pointer_axis_event(struct libinput_event *ev)
 		have_horiz = "*";
 	}
 	print_event_time(libinput_event_pointer_get_time(p));
-	printq("vert %.2f%s horiz %.2f%s (%s)\n",
+	printq("vert %.2f%s horiz %.2f%s (%s)",
 	       v, have_vert, h, have_horiz, source);
+
+	/* the velocity is only set on the terminating event */
+	if (v == 0.0 && h == 0.0) {
+		double vv = 0, vh = 0;
+
+		if (*have_vert)
+			vv = libinput_event_pointer_get_axis_velocity(p,
+				      LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+		if (*have_horiz)
+			vh = libinput_event_pointer_get_axis_velocity(p,
+				      LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+		printq(" velocity %.2f/%.2f", vv, vh);
+	}
+	printq("\n");
 }
 
 static void
@@ -836,6 +850,10 @@ handle_and_print_events(struct libinput *li)
 			break;
 		case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
 			print_proximity_event(ev);
+			tools_tablet_tool_apply_config(
+				libinput_event_tablet_tool_get_tool(
+					libinput_event_get_tablet_tool_event(ev)),
+				&options);
 			break;
 		case LIBINPUT_EVENT_TABLET_TOOL_TIP:
 			print_tablet_tip_event(ev);
@@ -72,6 +72,18 @@ draglock_default(struct libinput_device *device)
 		return "disabled";
 }
 
+static const char *
+adaptive_tap_default(struct libinput_device *device)
+{
+	if (!libinput_device_config_tap_get_finger_count(device))
+		return "n/a";
+
+	if (libinput_device_config_tap_get_default_adaptive_timeout_enabled(device))
+		return "enabled";
+	else
+		return "disabled";
+}
+
 static const char*
 left_handed_default(struct libinput_device *device)
 {
@@ -108,6 +120,18 @@ middle_emulation_default(struct libinput_device *device)
 		return "disabled";
 }
 
+static const char *
+adaptive_middle_emulation_default(struct libinput_device *device)
+{
+	if (!libinput_device_config_middle_emulation_is_available(device))
+		return "n/a";
+
+	if (libinput_device_config_middle_emulation_get_default_adaptive_timeout_enabled(device))
+		return "enabled";
+	else
+		return "disabled";
+}
+
 static char *
 calibration_default(struct libinput_device *device)
 {
@@ -242,6 +266,25 @@ rotation_default(struct libinput_device *device)
 	return str;
 }
 
+static char *
+resample_default(struct libinput_device *device)
+{
+	char *str;
+	unsigned int rate;
+
+	if (!libinput_device_config_resample_is_available(device)) {
+		xasprintf(&str, "n/a");
+		return str;
+	}
+
+	rate = libinput_device_config_resample_get_default_rate(device);
+	if (rate)
+		xasprintf(&str, "%uHz", rate);
+	else
+		xasprintf(&str, "disabled");
+	return str;
+}
+
 static void
 print_pad_info(struct libinput_device *device)
 {
@@ -328,9 +371,11 @@ print_device_notify(struct libinput_event *ev)
 	printf("Tap-to-click:     %s\n", tap_default(dev));
 	printf("Tap-and-drag:     %s\n",  drag_default(dev));
 	printf("Tap drag lock:    %s\n", draglock_default(dev));
+	printf("Adaptive tap:     %s\n", adaptive_tap_default(dev));
 	printf("Left-handed:      %s\n", left_handed_default(dev));
 	printf("Nat.scrolling:    %s\n", nat_scroll_default(dev));
 	printf("Middle emulation: %s\n", middle_emulation_default(dev));
+	printf("Adaptive middle:  %s\n", adaptive_middle_emulation_default(dev));
 	str = calibration_default(dev);
 	printf("Calibration:      %s\n", str);
 	free(str);
@@ -353,6 +398,10 @@ print_device_notify(struct libinput_event *ev)
 	printf("Rotation:         %s\n", str);
 	free(str);
 
+	str = resample_default(dev);
+	printf("Resampling:       %s\n", str);
+	free(str);
+
 	if (libinput_device_has_capability(dev,
 					   LIBINPUT_DEVICE_CAP_TABLET_PAD))
 		print_pad_info(dev);
@@ -0,0 +1,265 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <libinput.h>
+#include <libinput-util.h>
+
+#include "shared.h"
+
+/* libinput logs one line per phase when the touchpad is removed, see
+ * tp_profile_dump() */
+#define PROFILE_PREFIX "touchpad-profile: "
+
+struct phase {
+	char device[128];
+	char name[64];
+	uint64_t count;
+	uint64_t total;
+	uint64_t max;
+};
+
+static struct phase phases[64];
+static size_t nphases;
+static volatile sig_atomic_t stop = 0;
+
+LIBINPUT_ATTRIBUTE_PRINTF(3, 0)
+static void
+log_handler(struct libinput *li,
+	    enum libinput_log_priority priority,
+	    const char *format,
+	    va_list args)
+{
+	char buf[1024];
+	char *profile;
+	struct phase *p;
+	int rc;
+
+	vsnprintf(buf, sizeof(buf), format, args);
+	profile = strstr(buf, PROFILE_PREFIX);
+	if (!profile) {
+		if (priority >= LIBINPUT_LOG_PRIORITY_ERROR)
+			fprintf(stderr, "%s", buf);
+		return;
+	}
+
+	if (nphases >= ARRAY_LENGTH(phases))
+		return;
+
+	p = &phases[nphases];
+	rc = sscanf(profile + strlen(PROFILE_PREFIX),
+		    "%63s count %" SCNu64 " total %" SCNu64 "ns max %" SCNu64 "ns",
+		    p->name,
+		    &p->count,
+		    &p->total,
+		    &p->max);
+	if (rc != 4)
+		return;
+
+	/* the device prefix is everything up to the profile prefix,
+	 * minus the trailing ": " */
+	snprintf(p->device,
+		 sizeof(p->device),
+		 "%.*s",
+		 (int)max(profile - buf - 2, 0),
+		 buf);
+
+	nphases++;
+}
+
+static inline const char *
+phase_basename(const char *name, int *depth)
+{
+	const char *base = name;
+
+	*depth = 0;
+	for (const char *c = name; *c; c++) {
+		if (*c == '/') {
+			(*depth)++;
+			base = c + 1;
+		}
+	}
+
+	return base;
+}
+
+static void
+print_profile(void)
+{
+	const char *device = NULL;
+	uint64_t frame_total = 0;
+
+	for (size_t i = 0; i < nphases; i++) {
+		struct phase *p = &phases[i];
+		const char *name;
+		int depth;
+
+		if (!device || !streq(device, p->device)) {
+			device = p->device;
+			printf("\nTouchpad profile for %s\n", device);
+			printf("%-30s %10s %10s %10s %10s %7s\n",
+			       "phase", "calls", "avg (us)", "max (us)",
+			       "total (ms)", "% frame");
+			frame_total = 0;
+		}
+
+		name = phase_basename(p->name, &depth);
+		if (depth == 0)
+			frame_total = p->total;
+
+		printf("%*s%-*s %10" PRIu64 " %10.2f %10.2f %10.2f %7.1f\n",
+		       depth * 2, "",
+		       30 - depth * 2, name,
+		       p->count,
+		       p->total/1000.0/p->count,
+		       p->max/1000.0,
+		       p->total/1000000.0,
+		       frame_total ? 100.0 * p->total/frame_total : 0.0);
+	}
+}
+
+static void
+sighandler(int signal, siginfo_t *siginfo, void *userdata)
+{
+	stop = 1;
+}
+
+static int
+mainloop(struct libinput *li)
+{
+	struct pollfd fds;
+	struct sigaction act;
+	struct libinput_event *event;
+
+	fds.fd = libinput_get_fd(li);
+	fds.events = POLLIN;
+	fds.revents = 0;
+
+	memset(&act, 0, sizeof(act));
+	act.sa_sigaction = sighandler;
+	act.sa_flags = SA_SIGINFO;
+
+	if (sigaction(SIGINT, &act, NULL) == -1) {
+		fprintf(stderr, "Failed to set up signal handling (%s)\n",
+				strerror(errno));
+		return 1;
+	}
+
+	printf("Use the touchpad as usual. Hit Ctrl+C to print the profile.\n");
+
+	do {
+		libinput_dispatch(li);
+		while ((event = libinput_get_event(li)))
+			libinput_event_destroy(event);
+	} while (!stop && poll(&fds, 1, -1) > -1);
+
+	return 0;
+}
+
+static void
+usage(void)
+{
+	printf("Usage: libinput measure touchpad-profile [--help] [/dev/input/event0]\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct libinput *li;
+	char path[PATH_MAX];
+	const char *device = NULL;
+	bool grab = false;
+	int rc;
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option opts[] = {
+			{ "help", no_argument, 0, 'h' },
+			{ 0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "h", opts, &option_index);
+		if (c == -1)
+			break;
+
+		switch(c) {
+		case 'h':
+			usage();
+			return 0;
+		default:
+			usage();
+			return 1;
+		}
+	}
+
+	if (optind < argc - 1) {
+		usage();
+		return 1;
+	} else if (optind == argc - 1) {
+		device = argv[optind];
+	} else if (find_touchpad_device(path, sizeof(path))) {
+		device = path;
+	} else {
+		fprintf(stderr, "Unable to find a touchpad device.\n");
+		return 1;
+	}
+
+	if (!is_touchpad_device(device)) {
+		fprintf(stderr, "%s is not a touchpad device.\n", device);
+		return 1;
+	}
+
+	li = tools_open_backend(BACKEND_DEVICE, device, false, &grab);
+	if (!li)
+		return 1;
+
+	libinput_log_set_handler(li, log_handler);
+	libinput_log_set_priority(li, LIBINPUT_LOG_PRIORITY_INFO);
+
+	rc = mainloop(li);
+
+	/* The profile is logged when the device is removed */
+	libinput_unref(li);
+
+	if (nphases == 0) {
+		fprintf(stderr,
+			"No profile data. libinput needs to be built with "
+			"-Dtouchpad-profiling=true.\n");
+		return 1;
+	}
+
+	print_profile();
+
+	return rc;
+}
@@ -71,11 +71,15 @@ tools_init_options(struct tools_options *options)
 	options->tap_map = -1;
 	options->drag = -1;
 	options->drag_lock = -1;
+	options->adaptive_tap = -1;
 	options->natural_scroll = -1;
 	options->left_handed = -1;
 	options->middlebutton = -1;
+	options->adaptive_middlebutton = -1;
 	options->dwt = -1;
 	options->click_method = -1;
+	options->tablet_smoothing = -1;
+	options->resample_rate = -1;
 	options->scroll_method = -1;
 	options->scroll_button = -1;
 	options->speed = 0.0;
@@ -118,6 +122,12 @@ tools_parse_option(int option,
 	case OPT_DRAG_LOCK_DISABLE:
 		options->drag_lock = 0;
 		break;
+	case OPT_ADAPTIVE_TAP_ENABLE:
+		options->adaptive_tap = 1;
+		break;
+	case OPT_ADAPTIVE_TAP_DISABLE:
+		options->adaptive_tap = 0;
+		break;
 	case OPT_NATURAL_SCROLL_ENABLE:
 		options->natural_scroll = 1;
 		break;
@@ -136,6 +146,12 @@ tools_parse_option(int option,
 	case OPT_MIDDLEBUTTON_DISABLE:
 		options->middlebutton = 0;
 		break;
+	case OPT_ADAPTIVE_MIDDLEBUTTON_ENABLE:
+		options->adaptive_middlebutton = 1;
+		break;
+	case OPT_ADAPTIVE_MIDDLEBUTTON_DISABLE:
+		options->adaptive_middlebutton = 0;
+		break;
 	case OPT_DWT_ENABLE:
 		options->dwt = LIBINPUT_CONFIG_DWT_ENABLED;
 		break;
@@ -159,6 +175,34 @@ tools_parse_option(int option,
 			return 1;
 		}
 		break;
+	case OPT_TABLET_SMOOTHING:
+		if (!optarg)
+			return 1;
+
+		if (streq(optarg, "none")) {
+			options->tablet_smoothing =
+			LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_NONE;
+		} else if (streq(optarg, "average")) {
+			options->tablet_smoothing =
+			LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_AVERAGE;
+		} else if (streq(optarg, "adaptive")) {
+			options->tablet_smoothing =
+			LIBINPUT_CONFIG_TABLET_TOOL_SMOOTHING_ADAPTIVE;
+		} else {
+			return 1;
+		}
+		break;
+	case OPT_RESAMPLE_RATE:
+		if (!optarg)
+			return 1;
+		options->resample_rate = atoi(optarg);
+		if (options->resample_rate < 0) {
+			fprintf(stderr,
+				"Invalid resample rate %s\n",
+				optarg);
+			return 1;
+		}
+		break;
 	case OPT_SCROLL_METHOD:
 		if (!optarg)
 			return 1;
@@ -356,6 +400,9 @@ tools_device_apply_config(struct libinput_device *device,
 	if (options->drag_lock != -1)
 		libinput_device_config_tap_set_drag_lock_enabled(device,
 								 options->drag_lock);
+	if (options->adaptive_tap != -1)
+		libinput_device_config_tap_set_adaptive_timeout_enabled(device,
+									options->adaptive_tap);
 	if (options->natural_scroll != -1)
 		libinput_device_config_scroll_set_natural_scroll_enabled(device,
 									 options->natural_scroll);
@@ -364,6 +411,9 @@ tools_device_apply_config(struct libinput_device *device,
 	if (options->middlebutton != -1)
 		libinput_device_config_middle_emulation_set_enabled(device,
 								    options->middlebutton);
+	if (options->adaptive_middlebutton != -1)
+		libinput_device_config_middle_emulation_set_adaptive_timeout_enabled(device,
+										     options->adaptive_middlebutton);
 
 	if (options->dwt != -1)
 		libinput_device_config_dwt_set_enabled(device, options->dwt);
@@ -378,6 +428,10 @@ tools_device_apply_config(struct libinput_device *device,
 		libinput_device_config_scroll_set_button(device,
 							 options->scroll_button);
 
+	if (options->resample_rate != -1)
+		libinput_device_config_resample_set_rate(device,
+							 options->resample_rate);
+
 	if (libinput_device_config_accel_is_available(device)) {
 		libinput_device_config_accel_set_speed(device,
 						       options->speed);
@@ -396,6 +450,16 @@ tools_device_apply_config(struct libinput_device *device,
 	}
 }
 
+void
+tools_tablet_tool_apply_config(struct libinput_tablet_tool *tool,
+			       struct tools_options *options)
+{
+	if (options->tablet_smoothing !=
+	    (enum libinput_config_tablet_tool_smoothing)-1)
+		libinput_tablet_tool_config_smoothing_set_method(tool,
+								 options->tablet_smoothing);
+}
+
 static char*
 find_device(const char *udev_tag)
 {
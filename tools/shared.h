@@ -38,15 +38,21 @@ enum configuration_options {
 	OPT_DRAG_DISABLE,
 	OPT_DRAG_LOCK_ENABLE,
 	OPT_DRAG_LOCK_DISABLE,
+	OPT_ADAPTIVE_TAP_ENABLE,
+	OPT_ADAPTIVE_TAP_DISABLE,
 	OPT_NATURAL_SCROLL_ENABLE,
 	OPT_NATURAL_SCROLL_DISABLE,
 	OPT_LEFT_HANDED_ENABLE,
 	OPT_LEFT_HANDED_DISABLE,
 	OPT_MIDDLEBUTTON_ENABLE,
 	OPT_MIDDLEBUTTON_DISABLE,
+	OPT_ADAPTIVE_MIDDLEBUTTON_ENABLE,
+	OPT_ADAPTIVE_MIDDLEBUTTON_DISABLE,
 	OPT_DWT_ENABLE,
 	OPT_DWT_DISABLE,
 	OPT_CLICK_METHOD,
+	OPT_TABLET_SMOOTHING,
+	OPT_RESAMPLE_RATE,
 	OPT_SCROLL_METHOD,
 	OPT_SCROLL_BUTTON,
 	OPT_SPEED,
@@ -62,15 +68,21 @@ enum configuration_options {
 	{ "disable-drag",              no_argument,       0, OPT_DRAG_DISABLE }, \
 	{ "enable-drag-lock",          no_argument,       0, OPT_DRAG_LOCK_ENABLE }, \
 	{ "disable-drag-lock",         no_argument,       0, OPT_DRAG_LOCK_DISABLE }, \
+	{ "enable-adaptive-tap",       no_argument,       0, OPT_ADAPTIVE_TAP_ENABLE }, \
+	{ "disable-adaptive-tap",      no_argument,       0, OPT_ADAPTIVE_TAP_DISABLE }, \
 	{ "enable-natural-scrolling",  no_argument,       0, OPT_NATURAL_SCROLL_ENABLE }, \
 	{ "disable-natural-scrolling", no_argument,       0, OPT_NATURAL_SCROLL_DISABLE }, \
 	{ "enable-left-handed",        no_argument,       0, OPT_LEFT_HANDED_ENABLE }, \
 	{ "disable-left-handed",       no_argument,       0, OPT_LEFT_HANDED_DISABLE }, \
 	{ "enable-middlebutton",       no_argument,       0, OPT_MIDDLEBUTTON_ENABLE }, \
 	{ "disable-middlebutton",      no_argument,       0, OPT_MIDDLEBUTTON_DISABLE }, \
+	{ "enable-adaptive-middlebutton", no_argument,    0, OPT_ADAPTIVE_MIDDLEBUTTON_ENABLE }, \
+	{ "disable-adaptive-middlebutton", no_argument,   0, OPT_ADAPTIVE_MIDDLEBUTTON_DISABLE }, \
 	{ "enable-dwt",                no_argument,       0, OPT_DWT_ENABLE }, \
 	{ "disable-dwt",               no_argument,       0, OPT_DWT_DISABLE }, \
 	{ "set-click-method",          required_argument, 0, OPT_CLICK_METHOD }, \
+	{ "set-tablet-smoothing",      required_argument, 0, OPT_TABLET_SMOOTHING }, \
+	{ "set-resample-rate",         required_argument, 0, OPT_RESAMPLE_RATE }, \
 	{ "set-scroll-method",         required_argument, 0, OPT_SCROLL_METHOD }, \
 	{ "set-scroll-button",         required_argument, 0, OPT_SCROLL_BUTTON }, \
 	{ "set-profile",               required_argument, 0, OPT_PROFILE }, \
@@ -86,10 +98,14 @@ struct tools_options {
 	int tapping;
 	int drag;
 	int drag_lock;
+	int adaptive_tap;
 	int natural_scroll;
 	int left_handed;
 	int middlebutton;
+	int adaptive_middlebutton;
 	enum libinput_config_click_method click_method;
+	enum libinput_config_tablet_tool_smoothing tablet_smoothing;
+	int resample_rate;
 	enum libinput_config_scroll_method scroll_method;
 	enum libinput_config_tap_button_map tap_map;
 	int scroll_button;
@@ -109,6 +125,8 @@ struct libinput* tools_open_backend(enum tools_backend which,
 				    bool *grab);
 void tools_device_apply_config(struct libinput_device *device,
 			       struct tools_options *options);
+void tools_tablet_tool_apply_config(struct libinput_tablet_tool *tool,
+				    struct tools_options *options);
 int tools_exec_command(const char *prefix, int argc, char **argv);
 
 bool find_touchpad_device(char *path, size_t path_len);